@@ -8,12 +8,26 @@
  * 3. Farhan Ali - Roll No: 232522 (File I/O, Comparison Mode,)
  *
  * Features:
- * - 4 Page Replacement Algorithms
+ * - 5 Page Replacement Algorithms (FIFO, LRU, Optimal, Second Chance, Predictive)
  * - File Input/Output Support
  * - Algorithm Comparison Mode
  * - Step-by-Step Analysis: history tracking
  * - Performance Report Generation
  * - Multiple test cases: 4 different input methods supported
+ * - Belady's Anomaly Sweep: FIFO/Second Chance over a frame range (multi-core)
+ * - Batched FIFO kernel: many frame counts per trace pass (AVX2/SSE2)
+ * - Structure-of-arrays frame table with packed reference/dirty bitmaps
+ * - Live stream mode: online FIFO/LRU/Second Chance with periodic snapshots
+ * - Trace compaction: sparse 64-bit page numbers remapped to dense ids
+ * - Two-tier memory (DRAM + CXL/NVM) with promotion/demotion policies
+ * - Checkpoint/resume for long comparisons (asynchronous checkpoint writes)
+ * - Hash-partitioned parallel LRU/Second Chance with accuracy comparison
+ * - Object cache mode: variable sizes/costs, GreedyDual-Size and GDSF
+ * - Predictive (Hawkeye-style) replacement trained on replayed OPT decisions
+ * - Parameter tuning: parallel successive halving over aging CLOCK, LRU-K, SLRU
+ *
+ * Build: gcc vm_paging_simulator.c -o vm -pthread -lm
+ * Live:  tracer | ./vm --stream <frames> [snapshot interval]
  */
 
 #include <stdio.h>
@@ -21,9 +35,72 @@
 #include <stdbool.h>
 #include <string.h>
 #include <time.h>
+#include <stdint.h>
+#include <limits.h>
+#include <errno.h>
+#include <ctype.h>
+#include <math.h>
+#include <pthread.h>
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && defined(__SSE2__)
+#include <immintrin.h>
+#define HAVE_X86_SIMD 1
+#endif
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
 
 #define MAX_FRAMES 10
 #define MAX_PAGES 50
+#define MAX_THREADS 64
+#define SWEEP_TABLE_ROWS 50
+#define SIMD_NONE 0
+#define SIMD_SSE2 1
+#define SIMD_AVX2 2
+#define SIMD_LANES 8
+#define BATCH_MAX_LANES 64
+#define BATCH_STATE_BYTES (64LL * 1024 * 1024)
+#define CACHE_LINE 64
+#define POLICY_FIFO 0
+#define POLICY_LRU 1
+#define POLICY_SECOND_CHANCE 2
+#define ONLINE_POLICIES 3
+#define DEFAULT_SNAPSHOT_INTERVAL 100000
+#define TRACE_MAGIC "#VMTRACE"
+#define SEGLIST_SEGMENTS 3
+#define TIER_NONE 0
+#define TIER_DRAM 1
+#define TIER_SLOW 2
+#define DEFAULT_DRAM_NS 100.0
+#define DEFAULT_SLOW_NS 350.0
+#define DEFAULT_SWAP_NS 100000.0
+#define DEFAULT_HOT_THRESHOLD 2
+#define DEFAULT_DECAY_INTERVAL 10000
+#define DEFAULT_CHECKPOINT_INTERVAL 1000000
+#define CKPT_MAGIC "VMCKPT\0\0"
+#define CKPT_VERSION 5
+#define MAX_PARTITIONS 64
+#define SAFE_PARTITION_ERROR 1.0
+#define OBJECT_LRU 0
+#define OBJECT_GDS 1
+#define OBJECT_GDSF 2
+#define OBJECT_POLICIES 3
+#define NUM_ALGORITHMS 5
+#define PREDICTOR_BITS 11
+#define PREDICTOR_MAX 7
+#define PREDICTOR_THRESHOLD 4
+#define PREDICTOR_REGION_SHIFT 6
+#define SAMPLER_BITS 12
+#define OPTGEN_WINDOW_MULT 8
+#define OPTGEN_SAMPLED_FRAMES 64
+#define RRPV_MAX 7
+#define AGING_BUCKETS (RRPV_MAX - 1)
+#define MAX_TUNING_VALUES 10
+#define MIN_TUNING_PREFIX 1000
+#define TRACE_BAD_PAGE -1
+#define TRACE_BAD_SIZE -2
+#define TRACE_BAD_COST -3
 
 typedef struct {
     int pageFaults;
@@ -39,11 +116,247 @@ typedef struct {
     int steps;
 } SimulationHistory;
 
+/* Reference string with pages remapped to dense ids 0..distinctPages-1 */
+typedef struct {
+    int *refs;
+    uint64_t *pageIds;          /* remap table: dense id -> original page */
+    unsigned int *sizes;        /* per reference object size, NULL = all 1 */
+    float *costs;               /* per reference miss cost, NULL = all 1 */
+    int length;
+    int distinctPages;
+    bool owned;
+} Trace;
+
+typedef struct {
+    int *page;                  /* page in each frame, -1 if empty */
+    unsigned int *lastUse;      /* LRU timestamp of each frame */
+    uint64_t *referenceBits;    /* one bit per frame */
+    uint64_t *dirtyBits;        /* one bit per frame */
+    int capacity;
+    int paddedCapacity;
+    int filled;
+    int hand;
+} FrameTable;
+
+/*
+ * State of one policy fed one reference at a time. Only resident pages
+ * are tracked, so memory depends on the frame count, not the stream.
+ */
+typedef struct {
+    int policy;
+    int frameCount;
+    int filled;                 /* frames in use, filled in slot order */
+    int hand;                   /* Second Chance clock hand */
+    uint64_t *framePage;        /* page in each frame */
+    uint64_t *referenceBits;    /* Second Chance bits, one per frame */
+    uint64_t *hashKeys;         /* resident page -> slot, open addressing */
+    int *hashSlots;             /* -1 marks an empty bucket */
+    int hashBits;
+    int *prev, *next;           /* LRU order over slots, head = most recent */
+    int lruHead, lruTail;
+    int fifoPosition;
+    long long accesses, hits, faults;
+    long long windowAccesses, windowFaults;
+} OnlineSim;
+
+typedef struct {
+    long long accesses, hits, faults;
+    float hitRatio;
+    float faultRatio;
+    float windowFaultRatio;     /* since the previous snapshot */
+} OnlineStats;
+
+typedef struct {
+    int dramFrames;
+    int slowFrames;
+    double dramLatency, slowLatency, swapLatency;   /* ns per access served */
+    int demotionPolicy;
+    int promotionPolicy;
+    int hotThreshold;           /* hotness counter: slow-tier hits before promotion */
+    int decayInterval;          /* references between counter halvings */
+} TierConfig;
+
+typedef struct {
+    long long accesses;
+    long long dramHits, slowHits, faults;
+    long long promotions, demotions, swapOuts;
+    double totalLatency;
+} TierStats;
+
+/*
+ * Hawkeye-style predictor. OPTgen replays OPT over a window of recent
+ * accesses to label each reuse cache-friendly or cache-averse, and the
+ * labels train saturating counters, one per page region (original page
+ * >> PREDICTOR_REGION_SHIFT, hashed). Like Hawkeye's sampled sets, OPTgen only sees a hash-selected 1 / 2^k of the
+ * pages, replayed against frameCount / 2^k frames, so its cost per access
+ * does not grow with the frame count; other pages train on their own hits
+ * and evictions. Frames carry an RRIP value: averse pages are inserted at
+ * RRPV_MAX and go first.
+ *
+ * Friendly frames are aged lazily: a frame's RRPV is the number of friendly
+ * inserts (epoch) since its stamp, capped at RRPV_MAX - 1. Each RRPV has a
+ * bucket list in LRU order; RRPVs below the cap map onto a ring of
+ * AGING_BUCKETS lists that rotates with the epoch.
+ */
+typedef struct {
+    int frameCount;
+    int sampledFrames;          /* frames OPTgen replays for the sampled pages */
+    unsigned int sampleMask;    /* page is sampled if its hash has these bits clear */
+    int window;                 /* OPTgen history length in sampled accesses */
+    long long now;              /* sampled accesses so far */
+    long long epoch;            /* friendly inserts so far */
+    unsigned char *counters;    /* 3-bit counter per page region hash */
+    int *occupancy;             /* pages OPT holds at each time in the window */
+    uint64_t *samplerPage;      /* last page seen in each sampler entry */
+    long long *samplerTime;     /* its access time, -1 if empty */
+    long long *stamp;           /* per frame epoch of last friendly use, -1 if averse */
+    int *prev, *next;           /* per frame links within its bucket */
+    int head[RRPV_MAX + 1];     /* per bucket most recently used frame, -1 if empty */
+    int tail[RRPV_MAX + 1];     /* per bucket least recently used frame */
+} Predictor;
+
+/* Predictive with explicit, checkpointable state (see predictiveAccess) */
+typedef struct {
+    Predictor predictor;
+    int frameCount;
+    int distinctPages;
+    int filled;
+    int *framePage;             /* dense page in each frame */
+    int *slotOf;                /* page -> frame, -1 if not resident */
+    long long accesses, hits, faults;
+} PredictiveSim;
+
+/* Min-heap of ids 0..capacity-1 on key[id] (see indexedHeapSet) */
+typedef struct {
+    int *items;
+    int *pos;                   /* id -> heap index, -1 if not in the heap */
+    double *key;
+    int size;
+} IndexedHeap;
+
+/*
+ * Doubly linked lists over ids 0..capacity-1, one per segment 1..
+ * SEGLIST_SEGMENTS - 1, head = newest; segmentOf[id] is 0 off the lists.
+ */
+typedef struct {
+    unsigned char *segmentOf;
+    int *prev, *next;
+    int head[SEGLIST_SEGMENTS], tail[SEGLIST_SEGMENTS], count[SEGLIST_SEGMENTS];
+} SegList;
+
+/* Optimal with explicit, checkpointable state (see optimalAccess) */
+typedef struct {
+    int frameCount;
+    int distinctPages;
+    int *framePage;             /* dense page in each frame */
+    IndexedHeap heap;           /* filled frames on -(position of next use), -INT_MAX if none */
+    int *slotOf;                /* page -> frame, -1 if not resident */
+    long long accesses, hits, faults;
+} OptimalSim;
+
+/* Everything a checkpointed comparison needs to resume */
+typedef struct {
+    uint64_t fingerprint;       /* identifies the trace the state belongs to */
+    int frameCount;
+    int offset;                 /* next trace position to simulate */
+    OnlineSim online[ONLINE_POLICIES];
+    OptimalSim optimal;
+    PredictiveSim predictive;
+} LongRun;
+
+/* Growable byte buffer; when reading, length is the read position */
+typedef struct {
+    unsigned char *data;
+    size_t length;
+    size_t capacity;
+    bool ok;
+} CkptBuffer;
+
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    CkptBuffer pending;         /* newest snapshot not yet picked up */
+    bool hasPending;
+    bool stop;
+    char path[256];
+    int written, dropped, failed;
+} CheckpointWriter;
+
+/* Byte-capacity object cache with a priority heap (see objectCacheAccess) */
+typedef struct {
+    int policy;
+    long long capacityBytes;
+    long long usedBytes;
+    double inflation;           /* GreedyDual L value */
+    IndexedHeap heap;           /* cached object ids on priority */
+    unsigned int *cachedSize;
+    unsigned int *frequency;
+    long long requests, hits, evictions, bypassed;
+    long long requestedBytes, hitBytes;
+    double missCost;
+} ObjectCache;
+
+/* A policy with one integer knob, tried at each of `values` when tuning */
+typedef struct {
+    const char *name;
+    const char *parameter;
+    int values[MAX_TUNING_VALUES];
+    int valueCount;
+    int defaultValue;
+    int (*faults)(const Trace *t, int frameCount, int value);
+} TunableFamily;
+
+typedef struct TierSim TierSim;
+
+typedef struct {
+    const char *name;
+    void (*touch)(TierSim *sim, int tier, int page);    /* reorder a tier list on a hit */
+} DemotionPolicy;
+
+typedef struct {
+    const char *name;
+    bool (*shouldPromote)(TierSim *sim, int page);      /* called on each slow-tier hit */
+} PromotionPolicy;
+
+struct TierSim {
+    TierConfig cfg;
+    const DemotionPolicy *demotion;
+    const PromotionPolicy *promotion;
+    SegList tiers;              /* TIER_DRAM and TIER_SLOW lists, head = newest */
+    unsigned int *hotness;
+    unsigned int *hotEpoch;
+    long long now;
+    TierStats stats;
+};
+
+typedef struct {
+    uint64_t *keys;
+    int *ids;                   /* dense id per bucket, -1 if empty */
+    int bits;
+    int count;
+} PageMap;
+
+typedef struct {
+    int frameCount;
+    int fifoFaults;
+    int secondChanceFaults;
+} SweepResult;
+
+typedef struct {
+    void (*task)(void *ctx, int index);
+    void *ctx;
+    int numTasks;
+    int nextTask;
+    pthread_mutex_t lock;
+} WorkQueue;
+
 int frames[MAX_FRAMES];
 int pageRefs[MAX_PAGES];
 int numFrames, numPages;
 int pageFaults = 0, pageHits = 0;
 SimulationHistory history;
+Trace longTrace;
 
 void displayWelcome();
 void displayMainMenu();
@@ -56,6 +369,7 @@ void fifoAlgorithm();
 void lruAlgorithm();
 void optimalAlgorithm();
 void secondChanceAlgorithm();
+void predictiveAlgorithm();
 void compareAllAlgorithms();
 void generateDetailedReport();
 void showStats();
@@ -66,10 +380,90 @@ int searchPage(int page);
 void resetCounters();
 void resetFrames();
 void clearScreen();
+void displayAdvancedMenu();
+void advancedMenu();
+void loadLongTrace();
+void saveCompactedTrace();
+int pageMapInit(PageMap *m, int expected);
+void pageMapFree(PageMap *m);
+int pageMapIntern(PageMap *m, uint64_t page);
+int traceAppend(Trace *t, int *capacity, PageMap *m, uint64_t page, unsigned int size, float cost);
+int finishTrace(Trace *t, const PageMap *m);
+int parseTraceLine(const char *line, uint64_t *page, unsigned int *size, float *cost);
+const char *traceFieldName(int code);
+bool parsePageNumber(const char *token, int *page);
+int prepareTrace(const int *refs, int length, Trace *out);
+bool getAnalysisTrace(Trace *t);
+void releaseTrace(Trace *t);
+int getCoreCount();
+double wallSeconds();
+void runParallel(int numTasks, void (*task)(void *ctx, int index), void *ctx);
+void *alignedAlloc(size_t size);
+void alignedFree(void *p);
+int frameTableInit(FrameTable *ft, int capacity);
+void frameTableFree(FrameTable *ft);
+int frameTableClockVictim(FrameTable *ft);
+int frameTableLruVictim(const FrameTable *ft);
+int fifoFaultCount(const Trace *t, int frameCount);
+int secondChanceFaultCount(const Trace *t, int frameCount);
+int simdLevel();
+const char *simdName(int level);
+int batchWidthFor(int distinctPages);
+int fifoFaultsBatched(const Trace *t, const int *frameCounts, int count, int *faults, int level);
+void beladySweep();
+void batchedKernelBenchmark();
+void frameTableBenchmark();
+int onlineInit(OnlineSim *sim, int policy, int frameCount);
+void onlineFree(OnlineSim *sim);
+bool onlineAccess(OnlineSim *sim, uint64_t page);
+void onlineSnapshot(OnlineSim *sim, OnlineStats *out);
+const char *policyName(int policy);
+int runLiveStream(FILE *in, int frameCount, long long interval);
+void liveStreamSimulation();
+int streamFromCommandLine(int argc, char *argv[]);
+int simulateTiers(const Trace *t, const TierConfig *cfg, TierStats *out);
+void tieredMemorySimulation();
+int *buildNextUse(const Trace *t);
+int optimalInit(OptimalSim *sim, int frameCount, int distinctPages);
+void optimalFree(OptimalSim *sim);
+bool optimalAccess(OptimalSim *sim, const int *nextUse, int position, int page);
+int predictorInit(Predictor *p, int frameCount);
+void predictorFree(Predictor *p);
+bool predictorObserve(Predictor *p, uint64_t page);
+void predictorDetrain(Predictor *p, uint64_t page);
+int predictorRrpv(const Predictor *p, int frame);
+int predictorVictim(Predictor *p);
+void predictorHit(Predictor *p, int frame, uint64_t page, bool friendly);
+void predictorInsert(Predictor *p, int frame, bool friendly);
+int predictiveInit(PredictiveSim *sim, int frameCount, int distinctPages);
+void predictiveFree(PredictiveSim *sim);
+bool predictiveAccess(PredictiveSim *sim, const uint64_t *pageIds, int page);
+uint64_t traceFingerprint(const Trace *t);
+void saveCheckpoint(CkptBuffer *b, const LongRun *run);
+bool loadCheckpoint(const char *path, LongRun *run, const Trace *t);
+int startCheckpointWriter(CheckpointWriter *w, const char *path);
+void submitCheckpoint(CheckpointWriter *w, CkptBuffer *b);
+void stopCheckpointWriter(CheckpointWriter *w);
+void checkpointedComparison();
+int partitionTrace(const Trace *t, int partitions, Trace *parts, int **storage);
+void partitionedSimulation();
+int objectCacheInit(ObjectCache *c, int policy, long long capacityBytes, int distinctObjects);
+void objectCacheFree(ObjectCache *c);
+bool objectCacheAccess(ObjectCache *c, int id, unsigned int size, float cost, long long now);
+const char *objectPolicyName(int policy);
+void objectCacheSimulation();
+int agingClockFaultCount(const Trace *t, int frameCount, int bits);
+int lruKFaultCount(const Trace *t, int frameCount, int k);
+int slruFaultCount(const Trace *t, int frameCount, int protectedPercent);
+void parameterTuning();
 
-int main() {
+int main(int argc, char *argv[]) {
     int choice, algoChoice;
     
+    if(argc > 1 && strcmp(argv[1], "--stream") == 0) {
+        return streamFromCommandLine(argc, argv);
+    }
+    
     displayWelcome();
     
     while(1) {
@@ -96,7 +490,7 @@ int main() {
                 }
                 
                 printf("\n--- Select Algorithm ---\n");
-                printf("1. FIFO\n2. LRU\n3. Optimal\n4. Second Chance\n");
+                printf("1. FIFO\n2. LRU\n3. Optimal\n4. Second Chance\n5. Predictive (Hawkeye)\n");
                 printf("Enter choice: ");
                 scanf("%d", &algoChoice);
                 
@@ -109,6 +503,7 @@ int main() {
                     case 2: lruAlgorithm(); break;
                     case 3: optimalAlgorithm(); break;
                     case 4: secondChanceAlgorithm(); break;
+                    case 5: predictiveAlgorithm(); break;
                     default: printf("Invalid choice!\n");
                 }
                 break;
@@ -130,6 +525,10 @@ int main() {
                 break;
                 
             case 9:
+                advancedMenu();
+                break;
+                
+            case 10:
                 printf("\n========================================\n");
                 printf("Thank you for using the simulator!\n");
                 printf("Project by: [Group Member Names]\n");
@@ -172,7 +571,8 @@ void displayMainMenu() {
     printf("6. Compare All Algorithms\n");
     printf("7. View Simulation History\n");
     printf("8. Generate Performance Report\n");
-    printf("9. Exit\n");
+    printf("9. Advanced Analysis Tools\n");
+    printf("10. Exit\n");
     printf("========================================\n");
 }
 
@@ -184,6 +584,7 @@ int getChoice() {
 }
 
 void inputFromKeyboard() {
+    char token[32];
     int i;
     
     printf("\n--- Manual Input ---\n");
@@ -206,10 +607,14 @@ void inputFromKeyboard() {
     printf("Enter page reference string:\n");
     for(i = 0; i < numPages; i++) {
         printf("Page %d: ", i+1);
-        scanf("%d", &pageRefs[i]);
-        if(pageRefs[i] < 0) {
-            printf("Warning: Negative page number entered. Using absolute value.\n");
-            pageRefs[i] = abs(pageRefs[i]);
+        if(scanf("%31s", token) != 1) {
+            printf("\nError: Input ended early. Using default 0 for the remaining pages.\n");
+            for(; i < numPages; i++) pageRefs[i] = 0;
+            break;
+        }
+        if(!parsePageNumber(token, &pageRefs[i])) {
+            printf("Invalid! Page numbers must be between 0 and %d.\n", INT_MAX);
+            i--;
         }
     }
     
@@ -224,55 +629,67 @@ void inputFromKeyboard() {
 void inputFromFile() {
     FILE *fp;
     char filename[50];
-    int i;
+    char token[32];
+    int frameCount, pageCount, i;
     
     printf("\n--- Load from File ---\n");
     printf("Enter filename (e.g., input.txt): ");
     scanf("%s", filename);
     
+    /* Any error leaves no input: a half-read reference string is never simulated */
     fp = fopen(filename, "r");
     if(fp == NULL) {
         printf("Error: Cannot open file %s (File not found or permission denied)\n", filename);
+        numPages = 0;
         return;
     }
     
-    if(fscanf(fp, "%d", &numFrames) != 1) {
+    if(fscanf(fp, "%d", &frameCount) != 1) {
         printf("Error: Invalid file format. Expected number of frames.\n");
         fclose(fp);
+        numPages = 0;
         return;
     }
     
-    if(fscanf(fp, "%d", &numPages) != 1) {
+    if(fscanf(fp, "%d", &pageCount) != 1) {
         printf("Error: Invalid file format. Expected number of pages.\n");
         fclose(fp);
+        numPages = 0;
         return;
     }
     
-    if(numFrames < 1 || numFrames > MAX_FRAMES) {
-        printf("Error: Invalid number of frames in file (%d). Must be between 1 and %d.\n", numFrames, MAX_FRAMES);
+    if(frameCount < 1 || frameCount > MAX_FRAMES) {
+        printf("Error: Invalid number of frames in file (%d). Must be between 1 and %d.\n", frameCount, MAX_FRAMES);
         fclose(fp);
+        numPages = 0;
         return;
     }
     
-    if(numPages < 1 || numPages > MAX_PAGES) {
-        printf("Error: Invalid number of pages in file (%d). Must be between 1 and %d.\n", numPages, MAX_PAGES);
+    if(pageCount < 1 || pageCount > MAX_PAGES) {
+        printf("Error: Invalid number of pages in file (%d). Must be between 1 and %d.\n", pageCount, MAX_PAGES);
         fclose(fp);
+        numPages = 0;
         return;
     }
     
-    for(i = 0; i < numPages; i++) {
-        if(fscanf(fp, "%d", &pageRefs[i]) != 1) {
-            printf("Error: Invalid file format. Not enough page references (expected %d, got %d).\n", numPages, i);
+    for(i = 0; i < pageCount; i++) {
+        if(fscanf(fp, "%31s", token) != 1) {
+            printf("Error: Invalid file format. Not enough page references (expected %d, got %d).\n", pageCount, i);
             fclose(fp);
+            numPages = 0;
             return;
         }
-        if(pageRefs[i] < 0) {
-            printf("Warning: Negative page number found at position %d. Using absolute value.\n", i+1);
-            pageRefs[i] = abs(pageRefs[i]);
+        if(!parsePageNumber(token, &pageRefs[i])) {
+            printf("Error: Invalid page number '%s' at position %d. Must be between 0 and %d.\n", token, i+1, INT_MAX);
+            fclose(fp);
+            numPages = 0;
+            return;
         }
     }
     
     fclose(fp);
+    numFrames = frameCount;
+    numPages = pageCount;
     
     printf("\nFile loaded successfully!\n");
     printf("Frames: %d\n", numFrames);
@@ -672,8 +1089,70 @@ void secondChanceAlgorithm() {
     showStats();
 }
 
+/*
+ * Hawkeye-style replacement: each access is first fed to OPTgen, which
+ * trains the predictor with what OPT would have done, then the prediction
+ * for the page decides how long it is protected in memory.
+ */
+void predictiveAlgorithm() {
+    Predictor predictor;
+    int i;
+    int filled = 0;
+    
+    if(!predictorInit(&predictor, numFrames)) {
+        printf("\nError: Out of memory!\n");
+        return;
+    }
+    
+    printf("\n========================================\n");
+    printf("   Predictive (Hawkeye) Algorithm Simulation\n");
+    printf("========================================\n");
+    printf("\nStep\tPage\tStatus\t\tFrames\n");
+    printf("----\t----\t------\t\t------\n");
+    
+    for(i = 0; i < numPages; i++) {
+        int currentPage = pageRefs[i];
+        int pos = searchPage(currentPage);
+        bool friendly = predictorObserve(&predictor, (uint64_t)currentPage);
+        
+        printf("%d\t%d\t", i+1, currentPage);
+        
+        if(pos != -1) {
+            printf("HIT\t\t");
+            pageHits++;
+            predictorHit(&predictor, pos, (uint64_t)currentPage, friendly);
+            strcpy(history.status[i], "HIT");
+        }
+        else {
+            printf("FAULT\t\t");
+            pageFaults++;
+            strcpy(history.status[i], "FAULT");
+            
+            if(filled < numFrames) {
+                pos = filled;
+                filled++;
+            }
+            else {
+                pos = predictorVictim(&predictor);
+                if(predictorRrpv(&predictor, pos) < RRPV_MAX) {
+                    predictorDetrain(&predictor, (uint64_t)frames[pos]);
+                }
+            }
+            frames[pos] = currentPage;
+            predictorInsert(&predictor, pos, friendly);
+        }
+        
+        printFrames();
+        printf("\n");
+        saveFrameState(i);
+    }
+    
+    predictorFree(&predictor);
+    showStats();
+}
+
 void compareAllAlgorithms() {
-    AlgorithmStats stats[4];
+    AlgorithmStats stats[NUM_ALGORITHMS];
     int i;
     
     printf("\n========================================\n");
@@ -729,13 +1208,26 @@ void compareAllAlgorithms() {
     stats[3].faultRatio = (float)pageFaults / numPages * 100;
     strcpy(stats[3].algorithmName, "Second Chance");
     
+    printf("\n--- Press Enter for next algorithm ---");
+    fflush(stdin);
+    getchar();
+    
+    resetCounters();
+    resetFrames();
+    predictiveAlgorithm();
+    stats[4].pageFaults = pageFaults;
+    stats[4].pageHits = pageHits;
+    stats[4].hitRatio = (float)pageHits / numPages * 100;
+    stats[4].faultRatio = (float)pageFaults / numPages * 100;
+    strcpy(stats[4].algorithmName, "Predictive (Hawkeye)");
+    
     printf("\n\n========================================\n");
     printf("     COMPARISON SUMMARY\n");
     printf("========================================\n");
     printf("\nAlgorithm\t\tFaults\tHits\tFault%%\n");
     printf("------------------------------------------------\n");
     
-    for(i = 0; i < 4; i++) {
+    for(i = 0; i < NUM_ALGORITHMS; i++) {
         printf("%-20s\t%d\t%d\t%.2f%%\n", 
                stats[i].algorithmName, 
                stats[i].pageFaults, 
@@ -746,7 +1238,7 @@ void compareAllAlgorithms() {
     int minFaults = stats[0].pageFaults;
     int bestAlgo = 0;
     
-    for(i = 1; i < 4; i++) {
+    for(i = 1; i < NUM_ALGORITHMS; i++) {
         if(stats[i].pageFaults < minFaults) {
             minFaults = stats[i].pageFaults;
             bestAlgo = i;
@@ -765,7 +1257,7 @@ void generateDetailedReport() {
     struct tm *timeinfo;
     char timeStr[100];
     int i;
-    AlgorithmStats stats[4];
+    AlgorithmStats stats[NUM_ALGORITHMS];
     
     if(numPages == 0) {
         printf("\nNo data available for report!\n");
@@ -824,9 +1316,18 @@ void generateDetailedReport() {
     stats[3].faultRatio = (float)pageFaults / numPages * 100;
     strcpy(stats[3].algorithmName, "Second Chance");
     
+    resetCounters();
+    resetFrames();
+    predictiveAlgorithm();
+    stats[4].pageFaults = pageFaults;
+    stats[4].pageHits = pageHits;
+    stats[4].hitRatio = (float)pageHits / numPages * 100;
+    stats[4].faultRatio = (float)pageFaults / numPages * 100;
+    strcpy(stats[4].algorithmName, "Predictive (Hawkeye)");
+    
     int minFaults = stats[0].pageFaults;
     int bestAlgo = 0;
-    for(i = 1; i < 4; i++) {
+    for(i = 1; i < NUM_ALGORITHMS; i++) {
         if(stats[i].pageFaults < minFaults) {
             minFaults = stats[i].pageFaults;
             bestAlgo = i;
@@ -855,7 +1356,7 @@ void generateDetailedReport() {
     fprintf(fp, "%-20s | %8s | %8s | %10s | %10s\n", "Algorithm", "Faults", "Hits", "Fault %%", "Hit %%");
     fprintf(fp, "---------------------|----------|----------|------------|------------\n");
     
-    for(i = 0; i < 4; i++) {
+    for(i = 0; i < NUM_ALGORITHMS; i++) {
         fprintf(fp, "%-20s | %8d | %8d | %9.2f%% | %9.2f%%\n",
                stats[i].algorithmName,
                stats[i].pageFaults,
@@ -870,7 +1371,7 @@ void generateDetailedReport() {
     
     fprintf(fp, "\nDETAILED STATISTICS:\n");
     fprintf(fp, "-------------------\n");
-    for(i = 0; i < 4; i++) {
+    for(i = 0; i < NUM_ALGORITHMS; i++) {
         fprintf(fp, "\n%s Algorithm:\n", stats[i].algorithmName);
         fprintf(fp, "  Total Page References: %d\n", numPages);
         fprintf(fp, "  Total Page Faults:     %d\n", stats[i].pageFaults);
@@ -881,7 +1382,7 @@ void generateDetailedReport() {
     fprintf(fp, "\nPERFORMANCE ANALYSIS:\n");
     fprintf(fp, "--------------------\n");
     fprintf(fp, "Optimal Algorithm Performance: %d faults (theoretical best)\n", stats[2].pageFaults);
-    for(i = 0; i < 4; i++) {
+    for(i = 0; i < NUM_ALGORITHMS; i++) {
         if(i != 2) {  // Skip Optimal in comparison
             float efficiency = ((float)(stats[2].pageFaults - stats[i].pageFaults) / stats[2].pageFaults) * 100;
             if(efficiency < 0) efficiency = 0;
@@ -901,7 +1402,7 @@ void generateDetailedReport() {
     fclose(fp);
     
     printf("\nReport generated successfully: %s\n", filename);
-    printf("Report includes comparison of all 4 algorithms with detailed statistics.\n");
+    printf("Report includes comparison of all %d algorithms with detailed statistics.\n", NUM_ALGORITHMS);
 }
 
 void showStats() {
@@ -919,4 +1420,3991 @@ void showStats() {
     printf("Page Fault Ratio      : %.2f%%\n", faultRatio);
     printf("Page Hit Ratio        : %.2f%%\n", hitRatio);
     printf("========================================\n");
-}
\ No newline at end of file
+}
+void displayAdvancedMenu() {
+    printf("\n");
+    printf("========================================\n");
+    printf("        ADVANCED ANALYSIS TOOLS\n");
+    printf("========================================\n");
+    printf("1. Load Long Trace File (raw or compacted)\n");
+    printf("2. Save Compacted Trace + Remap Table\n");
+    printf("3. Belady's Anomaly Sweep (FIFO / Second Chance)\n");
+    printf("4. Batched Kernel Benchmark\n");
+    printf("5. Frame Table Benchmark (10^3 - 10^6 frames)\n");
+    printf("6. Live Stream Simulation (file or pipe)\n");
+    printf("7. Tiered Memory Simulation (DRAM + slow tier)\n");
+    printf("8. Long Comparison with Checkpoints\n");
+    printf("9. Hash-Partitioned Parallel Simulation\n");
+    printf("10. Object Cache Simulation (GreedyDual-Size / GDSF)\n");
+    printf("11. Policy Parameter Tuning (successive halving)\n");
+    printf("12. Back to Main Menu\n");
+    printf("========================================\n");
+    if(longTrace.length > 0)
+        printf("Loaded trace: %d references, %d distinct pages\n", longTrace.length, longTrace.distinctPages);
+    else
+        printf("No long trace loaded (tools use the current input)\n");
+}
+
+void advancedMenu() {
+    int choice;
+    
+    displayAdvancedMenu();
+    choice = getChoice();
+    
+    switch(choice) {
+        case 1:
+            loadLongTrace();
+            break;
+        case 2:
+            saveCompactedTrace();
+            break;
+        case 3:
+            beladySweep();
+            break;
+        case 4:
+            batchedKernelBenchmark();
+            break;
+        case 5:
+            frameTableBenchmark();
+            break;
+        case 6:
+            liveStreamSimulation();
+            break;
+        case 7:
+            tieredMemorySimulation();
+            break;
+        case 8:
+            checkpointedComparison();
+            break;
+        case 9:
+            partitionedSimulation();
+            break;
+        case 10:
+            objectCacheSimulation();
+            break;
+        case 11:
+            parameterTuning();
+            break;
+        case 12:
+            break;
+        default:
+            printf("\nInvalid choice!\n");
+    }
+}
+
+/*
+ * Page map: sparse 64-bit page numbers -> dense ids in order of first use.
+ * Open addressing with linear probing, grown at half load.
+ */
+static inline unsigned int hashPage(uint64_t page, int bits) {
+    page ^= page >> 30;
+    page *= 0xbf58476d1ce4e5b9ULL;
+    page ^= page >> 27;
+    page *= 0x94d049bb133111ebULL;
+    page ^= page >> 31;
+    return (unsigned int)(page >> (64 - bits));
+}
+
+int pageMapInit(PageMap *m, int expected) {
+    int size, i;
+    
+    m->bits = 4;
+    while((1 << m->bits) < 2 * expected && m->bits < 30) m->bits++;
+    size = 1 << m->bits;
+    m->count = 0;
+    m->keys = malloc(size * sizeof(uint64_t));
+    m->ids = malloc(size * sizeof(int));
+    if(m->keys == NULL || m->ids == NULL) {
+        pageMapFree(m);
+        return 0;
+    }
+    for(i = 0; i < size; i++) {
+        m->ids[i] = -1;
+    }
+    return 1;
+}
+
+void pageMapFree(PageMap *m) {
+    free(m->keys);
+    free(m->ids);
+    m->keys = NULL;
+    m->ids = NULL;
+    m->count = 0;
+}
+
+static int pageMapGrow(PageMap *m) {
+    PageMap bigger;
+    int oldSize = 1 << m->bits;
+    int i;
+    
+    bigger.bits = m->bits + 1;
+    bigger.count = m->count;
+    bigger.keys = malloc(((size_t)1 << bigger.bits) * sizeof(uint64_t));
+    bigger.ids = malloc(((size_t)1 << bigger.bits) * sizeof(int));
+    if(bigger.keys == NULL || bigger.ids == NULL) {
+        free(bigger.keys);
+        free(bigger.ids);
+        return 0;
+    }
+    for(i = 0; i < (1 << bigger.bits); i++) {
+        bigger.ids[i] = -1;
+    }
+    
+    for(i = 0; i < oldSize; i++) {
+        unsigned int h;
+        if(m->ids[i] == -1)
+            continue;
+        h = hashPage(m->keys[i], bigger.bits);
+        while(bigger.ids[h] != -1) {
+            h = (h + 1) & ((1u << bigger.bits) - 1);
+        }
+        bigger.keys[h] = m->keys[i];
+        bigger.ids[h] = m->ids[i];
+    }
+    
+    pageMapFree(m);
+    *m = bigger;
+    return 1;
+}
+
+/* Dense id of page, assigning the next free id on first use; -1 if out of memory */
+int pageMapIntern(PageMap *m, uint64_t page) {
+    unsigned int mask, h;
+    
+    if(2 * (m->count + 1) > (1 << m->bits) && !pageMapGrow(m))
+        return -1;
+    
+    mask = (1u << m->bits) - 1;
+    h = hashPage(page, m->bits);
+    while(m->ids[h] != -1) {
+        if(m->keys[h] == page)
+            return m->ids[h];
+        h = (h + 1) & mask;
+    }
+    m->keys[h] = page;
+    m->ids[h] = m->count;
+    return m->count++;
+}
+
+static int growObjectFields(Trace *t, int capacity) {
+    unsigned int *sizes = realloc(t->sizes, capacity * sizeof(unsigned int));
+    float *costs;
+    
+    if(sizes == NULL)
+        return 0;
+    t->sizes = sizes;
+    costs = realloc(t->costs, capacity * sizeof(float));
+    if(costs == NULL)
+        return 0;
+    t->costs = costs;
+    return 1;
+}
+
+/*
+ * Appends one raw reference to a trace being built; returns 0 if out of
+ * memory. Size/cost arrays are only created once a reference that is not
+ * unit size and unit cost shows up.
+ */
+int traceAppend(Trace *t, int *capacity, PageMap *m, uint64_t page, unsigned int size, float cost) {
+    int id, i;
+    
+    if(t->length == *capacity) {
+        int newCapacity = *capacity ? *capacity * 2 : 4096;
+        int *grown = realloc(t->refs, newCapacity * sizeof(int));
+        if(grown == NULL)
+            return 0;
+        t->refs = grown;
+        if(t->sizes != NULL && !growObjectFields(t, newCapacity))
+            return 0;
+        *capacity = newCapacity;
+    }
+    
+    if(t->sizes == NULL && (size != 1 || cost != 1.0f)) {
+        if(!growObjectFields(t, *capacity))
+            return 0;
+        for(i = 0; i < t->length; i++) {
+            t->sizes[i] = 1;
+            t->costs[i] = 1.0f;
+        }
+    }
+    
+    id = pageMapIntern(m, page);
+    if(id < 0)
+        return 0;
+    if(t->sizes != NULL) {
+        t->sizes[t->length] = size;
+        t->costs[t->length] = cost;
+    }
+    t->refs[t->length++] = id;
+    return 1;
+}
+
+/* Fills the remap table (dense id -> original page) from the page map */
+int finishTrace(Trace *t, const PageMap *m) {
+    int i;
+    
+    t->distinctPages = m->count;
+    t->pageIds = malloc((m->count ? m->count : 1) * sizeof(uint64_t));
+    if(t->pageIds == NULL)
+        return 0;
+    for(i = 0; i < (1 << m->bits); i++) {
+        if(m->ids[i] != -1)
+            t->pageIds[m->ids[i]] = m->keys[i];
+    }
+    return 1;
+}
+
+static void initTrace(Trace *t) {
+    t->refs = NULL;
+    t->pageIds = NULL;
+    t->sizes = NULL;
+    t->costs = NULL;
+    t->length = 0;
+    t->distinctPages = 0;
+    t->owned = true;
+}
+
+static inline bool traceFieldEnd(char c) {
+    return c == '\0' || c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/*
+ * One unsigned trace field: decimal, or hex after an explicit 0x. Leading
+ * zeros stay decimal. Returns the end of the field, NULL if it is not a
+ * number, overflows or runs into other characters.
+ */
+static const char *parseTraceNumber(const char *p, unsigned long long *value) {
+    char *end;
+    int base = 10;
+    
+    if(p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+        p += 2;
+        base = 16;
+        if(!isxdigit((unsigned char)p[0]) || (p[0] == '0' && (p[1] == 'x' || p[1] == 'X')))
+            return NULL;
+    }
+    else if(!isdigit((unsigned char)p[0])) {
+        return NULL;
+    }
+    errno = 0;
+    *value = strtoull(p, &end, base);
+    if(errno == ERANGE || !traceFieldEnd(*end))
+        return NULL;
+    return end;
+}
+
+/*
+ * Parses one trace line: "page [size [cost]]". Returns 1 for a reference,
+ * 0 for a blank or '#' comment line and TRACE_BAD_PAGE, TRACE_BAD_SIZE or
+ * TRACE_BAD_COST for the first invalid field. Page numbers are unsigned
+ * 64-bit, decimal or 0x hex; size (bytes, > 0) and cost (>= 0) default to 1.
+ */
+int parseTraceLine(const char *line, uint64_t *page, unsigned int *size, float *cost) {
+    const char *p = line;
+    char *end;
+    unsigned long long value;
+    double fetchCost;
+    
+    *size = 1;
+    *cost = 1.0f;
+    while(*p == ' ' || *p == '\t') p++;
+    if(*p == '\0' || *p == '\n' || *p == '\r' || *p == '#')
+        return 0;
+    
+    p = parseTraceNumber(p, &value);
+    if(p == NULL)
+        return TRACE_BAD_PAGE;
+    *page = value;
+    
+    while(*p == ' ' || *p == '\t') p++;
+    if(*p == '\0' || *p == '\n' || *p == '\r')
+        return 1;
+    p = parseTraceNumber(p, &value);
+    if(p == NULL || value == 0 || value > UINT_MAX)
+        return TRACE_BAD_SIZE;
+    *size = (unsigned int)value;
+    
+    while(*p == ' ' || *p == '\t') p++;
+    if(*p == '\0' || *p == '\n' || *p == '\r')
+        return 1;
+    errno = 0;
+    fetchCost = strtod(p, &end);
+    if(end == p || errno == ERANGE || !traceFieldEnd(*end) || !(fetchCost >= 0) || isinf(fetchCost))
+        return TRACE_BAD_COST;
+    *cost = (float)fetchCost;
+    return 1;
+}
+
+/* Number of whitespace-separated fields on a trace line */
+static int traceLineFields(const char *line) {
+    int fields = 0;
+    
+    while(*line != '\0') {
+        while(*line == ' ' || *line == '\t' || *line == '\n' || *line == '\r') line++;
+        if(*line == '\0')
+            break;
+        fields++;
+        while(!traceFieldEnd(*line)) line++;
+    }
+    return fields;
+}
+
+/* Field named by a negative parseTraceLine() result */
+const char *traceFieldName(int code) {
+    switch(code) {
+        case TRACE_BAD_SIZE: return "size";
+        case TRACE_BAD_COST: return "cost";
+        default: return "page number";
+    }
+}
+
+/* One page of the classic reference string: a trace page that fits an int */
+bool parsePageNumber(const char *token, int *page) {
+    uint64_t value;
+    unsigned int size;
+    float cost;
+    
+    if(parseTraceLine(token, &value, &size, &cost) != 1 || value > INT_MAX)
+        return false;
+    *page = (int)value;
+    return true;
+}
+
+/*
+ * Compacted trace file: header, remap table (one original page per id),
+ * dense refs. If the header's objects flag is 1 every ref line also
+ * carries the size and cost; if it is 0, none may. Remap entries
+ * must be distinct page numbers; ref lines are checked like raw trace lines.
+ */
+static bool loadCompactedTrace(FILE *fp, const char *header, Trace *t) {
+    PageMap map;
+    char line[256];
+    unsigned long long page;
+    int distinct, length, objects = 0, i;
+    
+    if(sscanf(header, TRACE_MAGIC " %d %d %d", &distinct, &length, &objects) < 2 || distinct < 1 || length < 1 ||
+       (objects != 0 && objects != 1)) {
+        printf("Error: Invalid compacted trace header.\n");
+        return false;
+    }
+    
+    t->refs = malloc(length * sizeof(int));
+    t->pageIds = malloc(distinct * sizeof(uint64_t));
+    if(t->refs == NULL || t->pageIds == NULL || (objects && !growObjectFields(t, length))) {
+        printf("Error: Out of memory.\n");
+        return false;
+    }
+    
+    if(!pageMapInit(&map, distinct)) {
+        printf("Error: Out of memory.\n");
+        return false;
+    }
+    for(i = 0; i < distinct; i++) {
+        const char *p = NULL;
+        int id;
+        
+        while(p == NULL && fgets(line, sizeof(line), fp) != NULL) {
+            p = line;
+            while(*p == ' ' || *p == '\t') p++;
+            if(*p == '\0' || *p == '\n' || *p == '\r')
+                p = NULL;
+        }
+        if(p == NULL) {
+            printf("Error: Remap table ends early (expected %d entries, got %d).\n", distinct, i);
+            pageMapFree(&map);
+            return false;
+        }
+        p = parseTraceNumber(p, &page);
+        if(p != NULL) {
+            while(*p == ' ' || *p == '\t') p++;
+        }
+        if(p == NULL || (*p != '\0' && *p != '\n' && *p != '\r')) {
+            printf("Error: Invalid page number in remap table entry %d.\n", i + 1);
+            pageMapFree(&map);
+            return false;
+        }
+        id = pageMapIntern(&map, page);
+        if(id < 0) {
+            printf("Error: Out of memory.\n");
+            pageMapFree(&map);
+            return false;
+        }
+        if(id != i) {
+            printf("Error: Remap table entry %d repeats page %llu.\n", i + 1, page);
+            pageMapFree(&map);
+            return false;
+        }
+        t->pageIds[i] = page;
+    }
+    pageMapFree(&map);
+    for(i = 0; i < length; i++) {
+        uint64_t id;
+        unsigned int size;
+        float cost;
+        int parsed = 0;
+        
+        while(parsed == 0 && fgets(line, sizeof(line), fp) != NULL) {
+            parsed = parseTraceLine(line, &id, &size, &cost);
+        }
+        if(parsed == 0) {
+            printf("Error: Compacted trace ends early (expected %d references, got %d).\n", length, i);
+            return false;
+        }
+        if(parsed < 0 || id >= (uint64_t)distinct) {
+            printf("Error: Invalid %s in reference %d of compacted trace.\n",
+                   parsed < 0 ? traceFieldName(parsed) : "page id", i + 1);
+            return false;
+        }
+        if(traceLineFields(line) != (objects ? 3 : 1)) {
+            printf("Error: Reference %d of compacted trace %s.\n", i + 1,
+                   objects ? "needs a size and a cost" : "has a size or cost, but the header's objects flag is 0");
+            return false;
+        }
+        t->refs[i] = (int)id;
+        if(objects) {
+            t->sizes[i] = size;
+            t->costs[i] = cost;
+        }
+    }
+    
+    t->length = length;
+    t->distinctPages = distinct;
+    return true;
+}
+
+/* Raw trace file: one "page [size [cost]]" per line, remapped while reading */
+static bool loadRawTrace(FILE *fp, const char *firstLine, Trace *t) {
+    PageMap map;
+    char line[256];
+    const char *current = firstLine;
+    int capacity = 0;
+    long long lineNo = 0;
+    bool ok = true;
+    
+    if(!pageMapInit(&map, 4096)) {
+        printf("Error: Out of memory.\n");
+        return false;
+    }
+    
+    while(current != NULL) {
+        uint64_t page;
+        unsigned int size;
+        float cost;
+        int parsed = parseTraceLine(current, &page, &size, &cost);
+        
+        lineNo++;
+        if(parsed < 0) {
+            printf("Error: Invalid %s on line %lld.\n", traceFieldName(parsed), lineNo);
+            ok = false;
+            break;
+        }
+        if(parsed > 0 && !traceAppend(t, &capacity, &map, page, size, cost)) {
+            printf("Error: Out of memory after %d references.\n", t->length);
+            ok = false;
+            break;
+        }
+        current = fgets(line, sizeof(line), fp);
+    }
+    
+    if(ok && t->length == 0) {
+        printf("Error: Trace file contains no page references.\n");
+        ok = false;
+    }
+    if(ok && !finishTrace(t, &map)) {
+        printf("Error: Out of memory.\n");
+        ok = false;
+    }
+    pageMapFree(&map);
+    return ok;
+}
+
+/*
+ * Long traces have no frame/page header and no MAX_PAGES limit. Raw
+ * traces (one page number per line) are compacted to dense ids on load;
+ * files written by saveCompactedTrace() are read back directly.
+ */
+void loadLongTrace() {
+    FILE *fp;
+    char filename[256];
+    char line[256];
+    Trace t;
+    bool ok;
+    
+    printf("\n--- Load Long Trace ---\n");
+    printf("Enter trace filename (raw or compacted): ");
+    scanf("%255s", filename);
+    
+    fp = fopen(filename, "r");
+    if(fp == NULL) {
+        printf("Error: Cannot open file %s (File not found or permission denied)\n", filename);
+        return;
+    }
+    
+    initTrace(&t);
+    if(fgets(line, sizeof(line), fp) == NULL) {
+        printf("Error: Trace file is empty.\n");
+        ok = false;
+    }
+    else if(strncmp(line, TRACE_MAGIC, strlen(TRACE_MAGIC)) == 0) {
+        ok = loadCompactedTrace(fp, line, &t);
+    }
+    else {
+        ok = loadRawTrace(fp, line, &t);
+    }
+    fclose(fp);
+    
+    if(!ok) {
+        releaseTrace(&t);
+        return;
+    }
+    
+    releaseTrace(&longTrace);
+    longTrace = t;
+    
+    printf("\nTrace loaded successfully!\n");
+    printf("References    : %d\n", longTrace.length);
+    printf("Distinct Pages: %d\n", longTrace.distinctPages);
+    printf("Sizes / Costs : %s\n", longTrace.sizes != NULL ? "yes" : "no (unit size and cost)");
+}
+
+void saveCompactedTrace() {
+    FILE *fp;
+    char filename[256];
+    int i;
+    
+    if(longTrace.length == 0) {
+        printf("\nNo long trace loaded!\n");
+        return;
+    }
+    
+    printf("\n--- Save Compacted Trace ---\n");
+    printf("Enter filename to save: ");
+    scanf("%255s", filename);
+    
+    fp = fopen(filename, "w");
+    if(fp == NULL) {
+        printf("Error: Cannot create file\n");
+        return;
+    }
+    
+    fprintf(fp, "%s %d %d %d\n", TRACE_MAGIC, longTrace.distinctPages, longTrace.length, longTrace.sizes != NULL);
+    for(i = 0; i < longTrace.distinctPages; i++) {
+        fprintf(fp, "%llu\n", (unsigned long long)longTrace.pageIds[i]);
+    }
+    for(i = 0; i < longTrace.length; i++) {
+        if(longTrace.sizes != NULL)
+            fprintf(fp, "%d %u %.9g\n", longTrace.refs[i], longTrace.sizes[i], longTrace.costs[i]);
+        else
+            fprintf(fp, "%d\n", longTrace.refs[i]);
+    }
+    
+    fclose(fp);
+    printf("Compacted trace with remap table (%d pages) saved to %s successfully!\n",
+           longTrace.distinctPages, filename);
+}
+
+/*
+ * Remaps page numbers to dense ids so the analysis kernels can use flat
+ * arrays indexed by page instead of scanning the frames on every access.
+ * Done once per trace and shared by every run/thread that uses it.
+ */
+int prepareTrace(const int *refs, int length, Trace *out) {
+    PageMap map;
+    int capacity = 0, i;
+    
+    initTrace(out);
+    if(!pageMapInit(&map, length))
+        return 0;
+    
+    for(i = 0; i < length; i++) {
+        if(!traceAppend(out, &capacity, &map, (uint64_t)refs[i], 1, 1.0f)) {
+            pageMapFree(&map);
+            releaseTrace(out);
+            return 0;
+        }
+    }
+    if(!finishTrace(out, &map)) {
+        pageMapFree(&map);
+        releaseTrace(out);
+        return 0;
+    }
+    pageMapFree(&map);
+    return 1;
+}
+
+/* Uses the long trace if one is loaded, otherwise the current input */
+bool getAnalysisTrace(Trace *t) {
+    if(longTrace.length > 0) {
+        *t = longTrace;
+        t->owned = false;
+        return true;
+    }
+    if(numPages == 0)
+        return false;
+    return prepareTrace(pageRefs, numPages, t) != 0;
+}
+
+void releaseTrace(Trace *t) {
+    if(t->owned) {
+        free(t->refs);
+        free(t->pageIds);
+        free(t->sizes);
+        free(t->costs);
+    }
+    t->refs = NULL;
+    t->pageIds = NULL;
+    t->sizes = NULL;
+    t->costs = NULL;
+    t->length = 0;
+    t->distinctPages = 0;
+}
+
+int getCoreCount() {
+    int n;
+    #ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        n = (int)info.dwNumberOfProcessors;
+    #else
+        n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    #endif
+    if(n < 1) n = 1;
+    if(n > MAX_THREADS) n = MAX_THREADS;
+    return n;
+}
+
+double wallSeconds() {
+    #ifdef _WIN32
+        LARGE_INTEGER freq, now;
+        QueryPerformanceFrequency(&freq);
+        QueryPerformanceCounter(&now);
+        return (double)now.QuadPart / freq.QuadPart;
+    #else
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec + ts.tv_nsec / 1e9;
+    #endif
+}
+
+static void *workerThread(void *arg) {
+    WorkQueue *q = arg;
+    
+    while(1) {
+        int index;
+        pthread_mutex_lock(&q->lock);
+        index = q->nextTask++;
+        pthread_mutex_unlock(&q->lock);
+        if(index >= q->numTasks)
+            break;
+        q->task(q->ctx, index);
+    }
+    return NULL;
+}
+
+/* Runs task(ctx, 0..numTasks-1) on a pool of one worker per core */
+void runParallel(int numTasks, void (*task)(void *ctx, int index), void *ctx) {
+    WorkQueue q;
+    pthread_t threads[MAX_THREADS];
+    int numThreads = getCoreCount();
+    int started = 0, i;
+    
+    q.task = task;
+    q.ctx = ctx;
+    q.numTasks = numTasks;
+    q.nextTask = 0;
+    pthread_mutex_init(&q.lock, NULL);
+    
+    if(numThreads > numTasks)
+        numThreads = numTasks;
+    
+    for(i = 1; i < numThreads; i++) {
+        if(pthread_create(&threads[started], NULL, workerThread, &q) != 0)
+            break;
+        started++;
+    }
+    workerThread(&q);
+    for(i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    
+    pthread_mutex_destroy(&q.lock);
+}
+
+/*
+ * Frame table for the analysis kernels, stored as a structure of arrays:
+ * page ids and LRU timestamps in 64-byte aligned arrays, reference and
+ * dirty bits packed 64 frames per word. Capacity is padded to a multiple
+ * of 64 frames; padding frames are never referenced and have the maximum
+ * timestamp, so victim scans need no tail handling.
+ */
+void *alignedAlloc(size_t size) {
+    void *p = NULL;
+    #ifdef _WIN32
+        p = _aligned_malloc(size, CACHE_LINE);
+    #else
+        if(posix_memalign(&p, CACHE_LINE, size) != 0)
+            p = NULL;
+    #endif
+    return p;
+}
+
+void alignedFree(void *p) {
+    #ifdef _WIN32
+        _aligned_free(p);
+    #else
+        free(p);
+    #endif
+}
+
+int frameTableInit(FrameTable *ft, int capacity) {
+    int padded = (capacity + 63) / 64 * 64;
+    int words = padded / 64;
+    int i;
+    
+    ft->capacity = capacity;
+    ft->paddedCapacity = padded;
+    ft->filled = 0;
+    ft->hand = 0;
+    ft->page = alignedAlloc(padded * sizeof(int));
+    ft->lastUse = alignedAlloc(padded * sizeof(unsigned int));
+    ft->referenceBits = alignedAlloc(words * sizeof(uint64_t));
+    ft->dirtyBits = alignedAlloc(words * sizeof(uint64_t));
+    if(ft->page == NULL || ft->lastUse == NULL || ft->referenceBits == NULL || ft->dirtyBits == NULL) {
+        frameTableFree(ft);
+        return 0;
+    }
+    
+    for(i = 0; i < padded; i++) {
+        ft->page[i] = -1;
+        ft->lastUse[i] = UINT_MAX;
+    }
+    memset(ft->referenceBits, 0, words * sizeof(uint64_t));
+    memset(ft->dirtyBits, 0, words * sizeof(uint64_t));
+    return 1;
+}
+
+void frameTableFree(FrameTable *ft) {
+    alignedFree(ft->page);
+    alignedFree(ft->lastUse);
+    alignedFree(ft->referenceBits);
+    alignedFree(ft->dirtyBits);
+    ft->page = NULL;
+    ft->lastUse = NULL;
+    ft->referenceBits = NULL;
+    ft->dirtyBits = NULL;
+}
+
+static inline void setFrameBit(uint64_t *bits, int frame) {
+    bits[frame >> 6] |= 1ULL << (frame & 63);
+}
+
+static inline void clearFrameBit(uint64_t *bits, int frame) {
+    bits[frame >> 6] &= ~(1ULL << (frame & 63));
+}
+
+static inline bool testFrameBit(const uint64_t *bits, int frame) {
+    return (bits[frame >> 6] >> (frame & 63)) & 1;
+}
+
+/*
+ * Second chance hand sweep, 64 frames per step: referenced frames between
+ * the hand and the victim lose their bit exactly as in the frame-by-frame
+ * loop of secondChanceAlgorithm(). Returns the first clear frame at or
+ * after `hand`.
+ */
+static int clockSweep(uint64_t *bits, int capacity, int hand) {
+    int lastWord = (capacity - 1) >> 6;
+    
+    while(1) {
+        int w = hand >> 6;
+        uint64_t valid = ~0ULL << (hand & 63);
+        uint64_t candidates;
+        
+        if(w == lastWord && (capacity & 63))
+            valid &= (1ULL << (capacity & 63)) - 1;
+        
+        candidates = ~bits[w] & valid;
+        if(candidates) {
+            int victim = (w << 6) + __builtin_ctzll(candidates);
+            bits[w] &= ~(valid & ((1ULL << (victim & 63)) - 1));
+            return victim;
+        }
+        
+        bits[w] &= ~valid;
+        hand = w == lastWord ? 0 : (w + 1) << 6;
+    }
+}
+
+/* Leaves the hand on the victim */
+int frameTableClockVictim(FrameTable *ft) {
+    ft->hand = clockSweep(ft->referenceBits, ft->capacity, ft->hand);
+    return ft->hand;
+}
+
+static int lruVictimScalar(const unsigned int *lastUse, int n) {
+    unsigned int minTime = UINT_MAX;
+    int i;
+    
+    for(i = 0; i < n; i++) {
+        if(lastUse[i] < minTime) minTime = lastUse[i];
+    }
+    for(i = 0; i < n; i++) {
+        if(lastUse[i] == minTime) return i;
+    }
+    return 0;
+}
+
+#ifdef HAVE_X86_SIMD
+__attribute__((target("avx2")))
+static int lruVictimAvx2(const unsigned int *lastUse, int n) {
+    __m256i minVec = _mm256_set1_epi32(-1);
+    __m128i half;
+    unsigned int minTime;
+    int i;
+    
+    for(i = 0; i < n; i += 8) {
+        minVec = _mm256_min_epu32(minVec, _mm256_load_si256((const __m256i *)(lastUse + i)));
+    }
+    half = _mm_min_epu32(_mm256_castsi256_si128(minVec), _mm256_extracti128_si256(minVec, 1));
+    half = _mm_min_epu32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+    half = _mm_min_epu32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+    minTime = (unsigned int)_mm_cvtsi128_si32(half);
+    
+    minVec = _mm256_set1_epi32((int)minTime);
+    for(i = 0; i < n; i += 8) {
+        __m256i eq = _mm256_cmpeq_epi32(minVec, _mm256_load_si256((const __m256i *)(lastUse + i)));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+        if(mask)
+            return i + __builtin_ctz(mask);
+    }
+    return 0;
+}
+#endif
+
+/* Frame with the oldest timestamp (first one on ties, like lruAlgorithm()) */
+int frameTableLruVictim(const FrameTable *ft) {
+    #ifdef HAVE_X86_SIMD
+        if(simdLevel() == SIMD_AVX2)
+            return lruVictimAvx2(ft->lastUse, ft->paddedCapacity);
+    #endif
+    return lruVictimScalar(ft->lastUse, ft->paddedCapacity);
+}
+
+/*
+ * LRU and Second Chance over a frame table. writes may be NULL; when it is
+ * given, written pages are marked dirty and evicting a dirty frame counts
+ * as a write-back.
+ */
+static int lruRun(const Trace *t, int frameCount, const unsigned char *writes, int *writeBacks) {
+    FrameTable ft;
+    int *slotOf = malloc(t->distinctPages * sizeof(int));
+    int i, faults = 0, flushed = 0;
+    
+    if(slotOf == NULL || !frameTableInit(&ft, frameCount)) {
+        free(slotOf);
+        return -1;
+    }
+    for(i = 0; i < t->distinctPages; i++) {
+        slotOf[i] = -1;
+    }
+    
+    for(i = 0; i < t->length; i++) {
+        int page = t->refs[i];
+        int slot = slotOf[page];
+        
+        if(slot == -1) {
+            faults++;
+            if(ft.filled < frameCount) {
+                slot = ft.filled++;
+            }
+            else {
+                slot = frameTableLruVictim(&ft);
+                slotOf[ft.page[slot]] = -1;
+                if(testFrameBit(ft.dirtyBits, slot)) {
+                    flushed++;
+                    clearFrameBit(ft.dirtyBits, slot);
+                }
+            }
+            ft.page[slot] = page;
+            slotOf[page] = slot;
+        }
+        ft.lastUse[slot] = (unsigned int)i;
+        if(writes != NULL && writes[i])
+            setFrameBit(ft.dirtyBits, slot);
+    }
+    
+    frameTableFree(&ft);
+    free(slotOf);
+    if(writeBacks != NULL) *writeBacks = flushed;
+    return faults;
+}
+
+static int clockRun(const Trace *t, int frameCount, const unsigned char *writes, int *writeBacks) {
+    FrameTable ft;
+    int *slotOf = malloc(t->distinctPages * sizeof(int));
+    int i, faults = 0, flushed = 0;
+    
+    if(slotOf == NULL || !frameTableInit(&ft, frameCount)) {
+        free(slotOf);
+        return -1;
+    }
+    for(i = 0; i < t->distinctPages; i++) {
+        slotOf[i] = -1;
+    }
+    
+    for(i = 0; i < t->length; i++) {
+        int page = t->refs[i];
+        int slot = slotOf[page];
+        
+        if(slot == -1) {
+            faults++;
+            if(ft.filled < frameCount) {
+                slot = ft.filled++;
+            }
+            else {
+                slot = frameTableClockVictim(&ft);
+                slotOf[ft.page[slot]] = -1;
+                if(testFrameBit(ft.dirtyBits, slot)) {
+                    flushed++;
+                    clearFrameBit(ft.dirtyBits, slot);
+                }
+                ft.hand = slot + 1 == frameCount ? 0 : slot + 1;
+            }
+            ft.page[slot] = page;
+            slotOf[page] = slot;
+        }
+        setFrameBit(ft.referenceBits, slot);
+        if(writes != NULL && writes[i])
+            setFrameBit(ft.dirtyBits, slot);
+    }
+    
+    frameTableFree(&ft);
+    free(slotOf);
+    if(writeBacks != NULL) *writeBacks = flushed;
+    return faults;
+}
+
+/* Same policy as fifoAlgorithm(), without printing or history */
+int fifoFaultCount(const Trace *t, int frameCount) {
+    char *resident = calloc(t->distinctPages, 1);
+    int *slots = malloc(frameCount * sizeof(int));
+    int i, faults = 0, filled = 0, position = 0;
+    
+    if(resident == NULL || slots == NULL) {
+        free(resident);
+        free(slots);
+        return -1;
+    }
+    
+    for(i = 0; i < t->length; i++) {
+        int page = t->refs[i];
+        
+        if(resident[page])
+            continue;
+        
+        faults++;
+        if(filled < frameCount) {
+            slots[filled++] = page;
+        }
+        else {
+            resident[slots[position]] = 0;
+            slots[position] = page;
+            position = (position + 1) % frameCount;
+        }
+        resident[page] = 1;
+    }
+    
+    free(resident);
+    free(slots);
+    return faults;
+}
+
+/* Same policy as secondChanceAlgorithm(), without printing or history */
+int secondChanceFaultCount(const Trace *t, int frameCount) {
+    return clockRun(t, frameCount, NULL, NULL);
+}
+
+/*
+ * Batched kernels: simulate several frame counts ("lanes") in lockstep
+ * over a single pass of the trace. Per-page state is stored lane-major
+ * (state[page * width + lane]) so one access loads the state of every
+ * configuration with a single vector load.
+ *
+ * FIFO never reorders on a hit, so the k-th insertion always evicts the
+ * page inserted frames faults earlier. A page is resident in a lane iff
+ * its insertion number is within the last `frames` faults of that lane,
+ * which turns the membership test and pointer update into pure vector
+ * arithmetic. Second Chance is not batched: each lane has its own hand and
+ * reference bits, so a batch shares little more than the trace read and
+ * ran slower than separate secondChanceFaultCount() runs.
+ */
+int simdLevel() {
+    static int level = -1;
+    
+    if(level < 0) {
+        #ifdef HAVE_X86_SIMD
+            __builtin_cpu_init();
+            level = __builtin_cpu_supports("avx2") ? SIMD_AVX2 : SIMD_SSE2;
+        #else
+            level = SIMD_NONE;
+        #endif
+    }
+    return level;
+}
+
+const char *simdName(int level) {
+    switch(level) {
+        case SIMD_AVX2: return "AVX2";
+        case SIMD_SSE2: return "SSE2";
+        default: return "scalar";
+    }
+}
+
+/* Lanes per batch, limited so the lane-major state stays around BATCH_STATE_BYTES */
+int batchWidthFor(int distinctPages) {
+    long long width = BATCH_STATE_BYTES / ((long long)distinctPages * sizeof(int));
+    
+    width -= width % SIMD_LANES;
+    if(width < SIMD_LANES) width = SIMD_LANES;
+    if(width > BATCH_MAX_LANES) width = BATCH_MAX_LANES;
+    return (int)width;
+}
+
+static void fifoBatchScalar(const Trace *t, int *seq, int width, int *faults, const int *frames) {
+    int i, k;
+    
+    for(i = 0; i < t->length; i++) {
+        int *s = seq + (size_t)t->refs[i] * width;
+        for(k = 0; k < width; k++) {
+            if(s[k] == 0 || s[k] <= faults[k] - frames[k])
+                s[k] = ++faults[k];
+        }
+    }
+}
+
+#ifdef HAVE_X86_SIMD
+static void fifoBatchSse2(const Trace *t, int *seq, int width, int *faults, const int *frames) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi32(-1);
+    int i, k;
+    
+    for(i = 0; i < t->length; i++) {
+        int *s = seq + (size_t)t->refs[i] * width;
+        for(k = 0; k < width; k += 4) {
+            __m128i v = _mm_loadu_si128((__m128i *)(s + k));
+            __m128i f = _mm_loadu_si128((__m128i *)(faults + k));
+            __m128i fr = _mm_loadu_si128((__m128i *)(frames + k));
+            __m128i hit = _mm_andnot_si128(_mm_cmpeq_epi32(v, zero),
+                                           _mm_cmpgt_epi32(v, _mm_sub_epi32(f, fr)));
+            __m128i miss = _mm_xor_si128(hit, ones);
+            f = _mm_sub_epi32(f, miss);
+            v = _mm_or_si128(_mm_and_si128(hit, v), _mm_andnot_si128(hit, f));
+            _mm_storeu_si128((__m128i *)(s + k), v);
+            _mm_storeu_si128((__m128i *)(faults + k), f);
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+static void fifoBatchAvx2(const Trace *t, int *seq, int width, int *faults, const int *frames) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi32(-1);
+    int i, k;
+    
+    for(i = 0; i < t->length; i++) {
+        int *s = seq + (size_t)t->refs[i] * width;
+        for(k = 0; k < width; k += 8) {
+            __m256i v = _mm256_loadu_si256((__m256i *)(s + k));
+            __m256i f = _mm256_loadu_si256((__m256i *)(faults + k));
+            __m256i fr = _mm256_loadu_si256((__m256i *)(frames + k));
+            __m256i hit = _mm256_andnot_si256(_mm256_cmpeq_epi32(v, zero),
+                                              _mm256_cmpgt_epi32(v, _mm256_sub_epi32(f, fr)));
+            f = _mm256_sub_epi32(f, _mm256_xor_si256(hit, ones));
+            v = _mm256_blendv_epi8(f, v, hit);
+            _mm256_storeu_si256((__m256i *)(s + k), v);
+            _mm256_storeu_si256((__m256i *)(faults + k), f);
+        }
+    }
+}
+#endif
+
+/* Runs FIFO for frameCounts[0..count-1] in one pass; returns 0 on out of memory */
+int fifoFaultsBatched(const Trace *t, const int *frameCounts, int count, int *faults, int level) {
+    int width = (count + SIMD_LANES - 1) / SIMD_LANES * SIMD_LANES;
+    int *seq, *laneFaults, *laneFrames;
+    int k;
+    
+    seq = calloc((size_t)t->distinctPages * width, sizeof(int));
+    laneFaults = calloc(width, sizeof(int));
+    laneFrames = malloc(width * sizeof(int));
+    if(seq == NULL || laneFaults == NULL || laneFrames == NULL) {
+        free(seq);
+        free(laneFaults);
+        free(laneFrames);
+        return 0;
+    }
+    
+    for(k = 0; k < width; k++) {
+        laneFrames[k] = k < count ? frameCounts[k] : 1;
+    }
+    
+    #ifdef HAVE_X86_SIMD
+        if(level == SIMD_AVX2)
+            fifoBatchAvx2(t, seq, width, laneFaults, laneFrames);
+        else if(level == SIMD_SSE2)
+            fifoBatchSse2(t, seq, width, laneFaults, laneFrames);
+        else
+    #endif
+            fifoBatchScalar(t, seq, width, laneFaults, laneFrames);
+    
+    memcpy(faults, laneFaults, count * sizeof(int));
+    free(seq);
+    free(laneFaults);
+    free(laneFrames);
+    return 1;
+}
+
+typedef struct {
+    const Trace *trace;
+    SweepResult *results;
+    int minFrames;
+    int count;
+    int lanesPerTask;
+    int simd;
+} SweepJob;
+
+/* One task simulates a batch of consecutive frame counts: FIFO in a single batched pass */
+static void sweepTask(void *ctx, int index) {
+    SweepJob *job = ctx;
+    int first = index * job->lanesPerTask;
+    int lanes = job->count - first;
+    int frameCounts[BATCH_MAX_LANES] = {0}, fifo[BATCH_MAX_LANES];
+    int k;
+    
+    if(lanes > job->lanesPerTask)
+        lanes = job->lanesPerTask;
+    for(k = 0; k < lanes; k++) {
+        frameCounts[k] = job->minFrames + first + k;
+    }
+    
+    if(!fifoFaultsBatched(job->trace, frameCounts, lanes, fifo, job->simd)) {
+        for(k = 0; k < lanes; k++) fifo[k] = fifoFaultCount(job->trace, frameCounts[k]);
+    }
+    
+    for(k = 0; k < lanes; k++) {
+        SweepResult *r = &job->results[first + k];
+        r->frameCount = frameCounts[k];
+        r->fifoFaults = fifo[k];
+        r->secondChanceFaults = secondChanceFaultCount(job->trace, frameCounts[k]);
+    }
+}
+
+/*
+ * Belady's anomaly: adding a frame must never add faults for a stack
+ * algorithm (LRU, Optimal), but FIFO and Second Chance are not stack
+ * algorithms. Every frame count in the range is simulated in parallel
+ * and each count whose faults rise over the previous one is flagged.
+ */
+void beladySweep() {
+    Trace t;
+    SweepJob job;
+    SweepResult *results;
+    int minFrames, maxFrames, count, i;
+    int fifoAnomalies = 0, scAnomalies = 0;
+    double start;
+    
+    if(!getAnalysisTrace(&t)) {
+        printf("\nError: No input data! Please enter data or load a trace first.\n");
+        return;
+    }
+    
+    printf("\n--- Belady's Anomaly Sweep ---\n");
+    printf("Trace: %d references, %d distinct pages\n", t.length, t.distinctPages);
+    printf("Enter minimum number of frames: ");
+    scanf("%d", &minFrames);
+    printf("Enter maximum number of frames: ");
+    scanf("%d", &maxFrames);
+    
+    if(minFrames < 1) {
+        printf("Invalid minimum! Using 1 frame.\n");
+        minFrames = 1;
+    }
+    if(maxFrames > t.distinctPages) {
+        /* Past this point every page fits and faults stay at the distinct count */
+        printf("Maximum limited to %d frames (number of distinct pages).\n", t.distinctPages);
+        maxFrames = t.distinctPages;
+    }
+    if(maxFrames <= minFrames) {
+        printf("Error: Frame range must contain at least two frame counts.\n");
+        releaseTrace(&t);
+        return;
+    }
+    
+    count = maxFrames - minFrames + 1;
+    results = malloc(count * sizeof(SweepResult));
+    if(results == NULL) {
+        printf("Error: Out of memory.\n");
+        releaseTrace(&t);
+        return;
+    }
+    
+    job.trace = &t;
+    job.results = results;
+    job.minFrames = minFrames;
+    job.count = count;
+    job.simd = simdLevel();
+    job.lanesPerTask = (count + getCoreCount() - 1) / getCoreCount();
+    if(job.lanesPerTask > batchWidthFor(t.distinctPages))
+        job.lanesPerTask = batchWidthFor(t.distinctPages);
+    
+    printf("\nSimulating %d frame counts on %d core(s), %d FIFO counts per trace pass (%s)...\n",
+           count, getCoreCount(), job.lanesPerTask, simdName(job.simd));
+    start = wallSeconds();
+    runParallel((count + job.lanesPerTask - 1) / job.lanesPerTask, sweepTask, &job);
+    
+    for(i = 0; i < count; i++) {
+        if(results[i].fifoFaults < 0 || results[i].secondChanceFaults < 0) {
+            printf("Error: Out of memory during simulation.\n");
+            free(results);
+            releaseTrace(&t);
+            return;
+        }
+    }
+    
+    printf("\nFrames\tFIFO\tSC\tAnomaly\n");
+    printf("------\t----\t--\t-------\n");
+    for(i = 0; i < count; i++) {
+        bool fifoUp = i > 0 && results[i].fifoFaults > results[i-1].fifoFaults;
+        bool scUp = i > 0 && results[i].secondChanceFaults > results[i-1].secondChanceFaults;
+        
+        if(fifoUp) fifoAnomalies++;
+        if(scUp) scAnomalies++;
+        
+        /* Long sweeps only list the anomalous frame counts */
+        if(count > SWEEP_TABLE_ROWS && !fifoUp && !scUp)
+            continue;
+        
+        printf("%d\t%d\t%d\t", results[i].frameCount, results[i].fifoFaults, results[i].secondChanceFaults);
+        if(fifoUp)
+            printf("FIFO +%d ", results[i].fifoFaults - results[i-1].fifoFaults);
+        if(scUp)
+            printf("SC +%d", results[i].secondChanceFaults - results[i-1].secondChanceFaults);
+        printf("\n");
+    }
+    
+    printf("\n========================================\n");
+    printf("FIFO anomalies          : %d\n", fifoAnomalies);
+    printf("Second Chance anomalies : %d\n", scAnomalies);
+    printf("Sweep time              : %.3f s\n", wallSeconds() - start);
+    if(fifoAnomalies == 0 && scAnomalies == 0)
+        printf(">>> No Belady's anomaly in this frame range.\n");
+    else
+        printf(">>> Belady's anomaly detected: adding frames increased faults.\n");
+    printf("========================================\n");
+    
+    free(results);
+    releaseTrace(&t);
+}
+
+/*
+ * Times K consecutive frame counts one run at a time against one batched pass,
+ * single-threaded, and checks that both give identical fault counts.
+ */
+void batchedKernelBenchmark() {
+    Trace t;
+    int frameCounts[BATCH_MAX_LANES];
+    int single[BATCH_MAX_LANES], batched[BATCH_MAX_LANES];
+    int configs, minFrames, k, level;
+    double start, singleTime, scalarTime, simdTime;
+    bool match = true;
+    
+    if(!getAnalysisTrace(&t)) {
+        printf("\nError: No input data! Please enter data or load a trace first.\n");
+        return;
+    }
+    
+    printf("\n--- Batched Kernel Benchmark ---\n");
+    printf("Trace: %d references, %d distinct pages\n", t.length, t.distinctPages);
+    printf("Enter number of configurations K (1-%d): ", BATCH_MAX_LANES);
+    scanf("%d", &configs);
+    
+    if(configs < 1 || configs > BATCH_MAX_LANES) {
+        printf("Invalid! Using %d configurations.\n", SIMD_LANES);
+        configs = SIMD_LANES;
+    }
+    
+    printf("Enter smallest frame count: ");
+    scanf("%d", &minFrames);
+    if(minFrames < 1) {
+        printf("Invalid! Starting at 1 frame.\n");
+        minFrames = 1;
+    }
+    
+    for(k = 0; k < configs; k++) {
+        frameCounts[k] = minFrames + k;
+    }
+    level = simdLevel();
+    
+    printf("\nPolicy\t\tK runs (s)\tScalar batch (s)\t%s batch (s)\tSpeedup\n", simdName(level));
+    printf("------\t\t----------\t----------------\t--------------\t-------\n");
+    
+    start = wallSeconds();
+    for(k = 0; k < configs; k++) single[k] = fifoFaultCount(&t, frameCounts[k]);
+    singleTime = wallSeconds() - start;
+    start = wallSeconds();
+    fifoFaultsBatched(&t, frameCounts, configs, batched, SIMD_NONE);
+    scalarTime = wallSeconds() - start;
+    start = wallSeconds();
+    if(!fifoFaultsBatched(&t, frameCounts, configs, batched, level)) {
+        printf("Error: Out of memory.\n");
+        releaseTrace(&t);
+        return;
+    }
+    simdTime = wallSeconds() - start;
+    for(k = 0; k < configs; k++) {
+        if(single[k] != batched[k]) match = false;
+    }
+    printf("FIFO\t\t%.4f\t\t%.4f\t\t\t%.4f\t\t%.2fx\n", singleTime, scalarTime, simdTime,
+           simdTime > 0 ? singleTime / simdTime : 0.0);
+    
+    printf("\nThroughput is %d references x %d configurations per pass.\n", t.length, configs);
+    if(match)
+        printf(">>> Batched results match the single-configuration runs.\n");
+    else
+        printf(">>> ERROR: Batched results differ from the single-configuration runs!\n");
+    
+    releaseTrace(&t);
+}
+
+/* rand() may only give 15 bits (Windows), so combine two calls for large ranges */
+static int randomIndex(int n) {
+    long long r = (long long)rand() * ((long long)RAND_MAX + 1) + rand();
+    return (int)(r % n);
+}
+
+/*
+ * Reference layout for the benchmark: the one-int-per-field arrays used by
+ * lruAlgorithm() and secondChanceAlgorithm(), with the same dense lookup
+ * table as the frame-table kernels so only the frame metadata differs.
+ */
+static int legacyRun(const Trace *t, int frameCount, const unsigned char *writes, int *writeBacks, bool lru) {
+    int *frameArr = malloc(frameCount * sizeof(int));
+    int *recent = malloc(frameCount * sizeof(int));
+    int *referenceBit = malloc(frameCount * sizeof(int));
+    int *dirty = calloc(frameCount, sizeof(int));
+    int *slotOf = malloc(t->distinctPages * sizeof(int));
+    int i, j, faults = 0, flushed = 0, filled = 0, pointer = 0;
+    
+    if(frameArr == NULL || recent == NULL || referenceBit == NULL || dirty == NULL || slotOf == NULL) {
+        faults = -1;
+        goto done;
+    }
+    for(i = 0; i < t->distinctPages; i++) {
+        slotOf[i] = -1;
+    }
+    
+    for(i = 0; i < t->length; i++) {
+        int page = t->refs[i];
+        int slot = slotOf[page];
+        
+        if(slot == -1) {
+            faults++;
+            if(filled < frameCount) {
+                slot = filled++;
+            }
+            else if(lru) {
+                int minTime = recent[0];
+                slot = 0;
+                for(j = 1; j < frameCount; j++) {
+                    if(recent[j] < minTime) {
+                        minTime = recent[j];
+                        slot = j;
+                    }
+                }
+            }
+            else {
+                while(referenceBit[pointer]) {
+                    referenceBit[pointer] = 0;
+                    pointer = (pointer + 1) % frameCount;
+                }
+                slot = pointer;
+                pointer = (pointer + 1) % frameCount;
+            }
+            if(faults > frameCount) {
+                slotOf[frameArr[slot]] = -1;
+                if(dirty[slot]) flushed++;
+            }
+            frameArr[slot] = page;
+            dirty[slot] = 0;
+            slotOf[page] = slot;
+        }
+        recent[slot] = i;
+        referenceBit[slot] = 1;
+        if(writes != NULL && writes[i])
+            dirty[slot] = 1;
+    }
+    
+done:
+    free(frameArr);
+    free(recent);
+    free(referenceBit);
+    free(dirty);
+    free(slotOf);
+    if(writeBacks != NULL) *writeBacks = flushed;
+    return faults;
+}
+
+/*
+ * Synthetic workload per frame count: a cold pass over F pages fills the
+ * table, then 90% of references hit the first F pages and 10% come from a
+ * second set of F pages. A quarter of all references are writes.
+ */
+void frameTableBenchmark() {
+    int sizes[] = { 1000, 10000, 100000, 1000000 };
+    int s, i;
+    
+    printf("\n--- Frame Table Benchmark ---\n");
+    printf("Victim scans: %s\n\n", simdLevel() == SIMD_AVX2 ? "AVX2" : "scalar");
+    printf("%-8s %-6s %10s %10s %10s %10s %8s\n", "Frames", "Policy", "Refs", "Faults", "Legacy(s)", "SoA(s)", "Speedup");
+    printf("-------- ------ ---------- ---------- ---------- ---------- --------\n");
+    
+    srand(12345);
+    for(s = 0; s < 4; s++) {
+        int frameCount = sizes[s];
+        int steady = 200000000 / frameCount;
+        Trace t;
+        unsigned char *writes;
+        int policy;
+        
+        if(steady < 20000) steady = 20000;
+        if(steady > 2000000) steady = 2000000;
+        
+        t.length = frameCount + steady;
+        t.distinctPages = 2 * frameCount;
+        t.owned = true;
+        t.pageIds = NULL;
+        t.sizes = NULL;
+        t.costs = NULL;
+        t.refs = malloc(t.length * sizeof(int));
+        writes = malloc(t.length);
+        if(t.refs == NULL || writes == NULL) {
+            printf("Error: Out of memory.\n");
+            free(t.refs);
+            free(writes);
+            return;
+        }
+        
+        for(i = 0; i < t.length; i++) {
+            if(i < frameCount)
+                t.refs[i] = i;
+            else if(rand() % 10 != 0)
+                t.refs[i] = randomIndex(frameCount);
+            else
+                t.refs[i] = frameCount + randomIndex(frameCount);
+            writes[i] = rand() % 4 == 0;
+        }
+        
+        for(policy = 0; policy < 2; policy++) {
+            bool lru = policy == 0;
+            int legacyFaults, soaFaults, legacyFlushed, soaFlushed;
+            double start, legacyTime, soaTime;
+            
+            start = wallSeconds();
+            legacyFaults = legacyRun(&t, frameCount, writes, &legacyFlushed, lru);
+            legacyTime = wallSeconds() - start;
+            
+            start = wallSeconds();
+            if(lru)
+                soaFaults = lruRun(&t, frameCount, writes, &soaFlushed);
+            else
+                soaFaults = clockRun(&t, frameCount, writes, &soaFlushed);
+            soaTime = wallSeconds() - start;
+            
+            if(legacyFaults < 0 || soaFaults < 0) {
+                printf("%-8d %-6s Out of memory\n", frameCount, lru ? "LRU" : "CLOCK");
+                continue;
+            }
+            
+            printf("%-8d %-6s %10d %10d %10.4f %10.4f %7.2fx%s\n",
+                   frameCount, lru ? "LRU" : "CLOCK", t.length, soaFaults, legacyTime, soaTime,
+                   soaTime > 0 ? legacyTime / soaTime : 0.0,
+                   (legacyFaults != soaFaults || legacyFlushed != soaFlushed) ? "  MISMATCH" : "");
+        }
+        
+        free(t.refs);
+        free(writes);
+    }
+}
+
+const char *policyName(int policy) {
+    switch(policy) {
+        case POLICY_FIFO: return "FIFO";
+        case POLICY_LRU: return "LRU";
+        case POLICY_SECOND_CHANCE: return "Second Chance";
+        default: return "Unknown";
+    }
+}
+
+int onlineInit(OnlineSim *sim, int policy, int frameCount) {
+    int size, i;
+    
+    memset(sim, 0, sizeof(*sim));
+    sim->policy = policy;
+    sim->frameCount = frameCount;
+    sim->lruHead = sim->lruTail = -1;
+    
+    sim->hashBits = 1;
+    while((1 << sim->hashBits) < 2 * frameCount) sim->hashBits++;
+    size = 1 << sim->hashBits;
+    
+    sim->framePage = malloc(frameCount * sizeof(uint64_t));
+    sim->referenceBits = calloc((frameCount + 63) / 64, sizeof(uint64_t));
+    sim->hashKeys = malloc(size * sizeof(uint64_t));
+    sim->hashSlots = malloc(size * sizeof(int));
+    sim->prev = malloc(frameCount * sizeof(int));
+    sim->next = malloc(frameCount * sizeof(int));
+    if(sim->framePage == NULL || sim->referenceBits == NULL || sim->hashKeys == NULL ||
+       sim->hashSlots == NULL || sim->prev == NULL || sim->next == NULL) {
+        onlineFree(sim);
+        return 0;
+    }
+    
+    for(i = 0; i < size; i++) {
+        sim->hashSlots[i] = -1;
+    }
+    return 1;
+}
+
+void onlineFree(OnlineSim *sim) {
+    free(sim->framePage);
+    free(sim->hashKeys);
+    free(sim->hashSlots);
+    free(sim->prev);
+    free(sim->next);
+    free(sim->referenceBits);
+    sim->framePage = sim->hashKeys = sim->referenceBits = NULL;
+    sim->hashSlots = sim->prev = sim->next = NULL;
+}
+
+static inline int onlineHash(const OnlineSim *sim, uint64_t page) {
+    return (int)hashPage(page, sim->hashBits);
+}
+
+static int onlineLookup(const OnlineSim *sim, uint64_t page) {
+    int mask = (1 << sim->hashBits) - 1;
+    int h = onlineHash(sim, page);
+    
+    while(sim->hashSlots[h] != -1) {
+        if(sim->hashKeys[h] == page)
+            return sim->hashSlots[h];
+        h = (h + 1) & mask;
+    }
+    return -1;
+}
+
+static void onlineInsert(OnlineSim *sim, uint64_t page, int slot) {
+    int mask = (1 << sim->hashBits) - 1;
+    int h = onlineHash(sim, page);
+    
+    while(sim->hashSlots[h] != -1) {
+        h = (h + 1) & mask;
+    }
+    sim->hashKeys[h] = page;
+    sim->hashSlots[h] = slot;
+}
+
+/* Linear probing delete: shift later entries of the cluster back into the hole */
+static void onlineRemove(OnlineSim *sim, uint64_t page) {
+    int mask = (1 << sim->hashBits) - 1;
+    int hole = onlineHash(sim, page);
+    int h;
+    
+    while(sim->hashKeys[hole] != page) {
+        hole = (hole + 1) & mask;
+    }
+    
+    h = hole;
+    while(1) {
+        int home;
+        h = (h + 1) & mask;
+        if(sim->hashSlots[h] == -1)
+            break;
+        home = onlineHash(sim, sim->hashKeys[h]);
+        if(((h - home) & mask) >= ((h - hole) & mask)) {
+            sim->hashKeys[hole] = sim->hashKeys[h];
+            sim->hashSlots[hole] = sim->hashSlots[h];
+            hole = h;
+        }
+    }
+    sim->hashSlots[hole] = -1;
+}
+
+static void lruUnlink(OnlineSim *sim, int slot) {
+    if(sim->prev[slot] != -1) sim->next[sim->prev[slot]] = sim->next[slot];
+    else sim->lruHead = sim->next[slot];
+    if(sim->next[slot] != -1) sim->prev[sim->next[slot]] = sim->prev[slot];
+    else sim->lruTail = sim->prev[slot];
+}
+
+static void lruPushFront(OnlineSim *sim, int slot) {
+    sim->prev[slot] = -1;
+    sim->next[slot] = sim->lruHead;
+    if(sim->lruHead != -1) sim->prev[sim->lruHead] = slot;
+    else sim->lruTail = slot;
+    sim->lruHead = slot;
+}
+
+/* Feeds one reference to the policy; returns true on a hit */
+bool onlineAccess(OnlineSim *sim, uint64_t page) {
+    int slot = onlineLookup(sim, page);
+    
+    sim->accesses++;
+    sim->windowAccesses++;
+    
+    if(slot != -1) {
+        sim->hits++;
+        if(sim->policy == POLICY_LRU) {
+            lruUnlink(sim, slot);
+            lruPushFront(sim, slot);
+        }
+        else if(sim->policy == POLICY_SECOND_CHANCE) {
+            setFrameBit(sim->referenceBits, slot);
+        }
+        return true;
+    }
+    
+    sim->faults++;
+    sim->windowFaults++;
+    
+    if(sim->filled < sim->frameCount) {
+        slot = sim->filled++;
+    }
+    else {
+        switch(sim->policy) {
+            case POLICY_FIFO:
+                slot = sim->fifoPosition;
+                sim->fifoPosition = (sim->fifoPosition + 1) % sim->frameCount;
+                break;
+            case POLICY_LRU:
+                slot = sim->lruTail;
+                lruUnlink(sim, slot);
+                break;
+            default:
+                slot = clockSweep(sim->referenceBits, sim->frameCount, sim->hand);
+                sim->hand = slot + 1 == sim->frameCount ? 0 : slot + 1;
+                break;
+        }
+        onlineRemove(sim, sim->framePage[slot]);
+    }
+    
+    sim->framePage[slot] = page;
+    onlineInsert(sim, page, slot);
+    if(sim->policy == POLICY_LRU)
+        lruPushFront(sim, slot);
+    else if(sim->policy == POLICY_SECOND_CHANCE)
+        setFrameBit(sim->referenceBits, slot);
+    return false;
+}
+
+/* Totals so far plus the fault ratio since the previous snapshot */
+void onlineSnapshot(OnlineSim *sim, OnlineStats *out) {
+    out->accesses = sim->accesses;
+    out->hits = sim->hits;
+    out->faults = sim->faults;
+    out->hitRatio = sim->accesses ? (float)sim->hits / sim->accesses * 100 : 0;
+    out->faultRatio = sim->accesses ? (float)sim->faults / sim->accesses * 100 : 0;
+    out->windowFaultRatio = sim->windowAccesses ? (float)sim->windowFaults / sim->windowAccesses * 100 : 0;
+    sim->windowAccesses = 0;
+    sim->windowFaults = 0;
+}
+
+static void printStreamSnapshot(OnlineSim sims[]) {
+    OnlineStats st;
+    int p;
+    
+    for(p = 0; p < ONLINE_POLICIES; p++) {
+        onlineSnapshot(&sims[p], &st);
+        if(p == 0)
+            printf("%12lld", st.accesses);
+        printf(" | %7.2f%% %7.2f%%", st.faultRatio, st.windowFaultRatio);
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+/*
+ * Runs FIFO, LRU and Second Chance side by side on a reference stream,
+ * one page number per line, printing a snapshot every `interval`
+ * references. Nothing but the resident pages is kept.
+ */
+int runLiveStream(FILE *in, int frameCount, long long interval) {
+    OnlineSim sims[ONLINE_POLICIES];
+    OnlineStats st;
+    char line[256];
+    long long lineNo = 0;
+    int p;
+    
+    for(p = 0; p < ONLINE_POLICIES; p++) {
+        if(!onlineInit(&sims[p], p, frameCount)) {
+            printf("Error: Out of memory.\n");
+            while(--p >= 0) onlineFree(&sims[p]);
+            return 1;
+        }
+    }
+    
+    printf("\nFault ratio so far and since the previous snapshot:\n");
+    printf("%12s | %8s %8s | %8s %8s | %8s %8s\n", "References", "FIFO", "window", "LRU", "window", "SC", "window");
+    printf("-------------|-------------------|-------------------|------------------\n");
+    
+    while(fgets(line, sizeof(line), in) != NULL) {
+        uint64_t page;
+        unsigned int size;
+        float cost;
+        int parsed = parseTraceLine(line, &page, &size, &cost);
+        
+        lineNo++;
+        if(parsed == 0)
+            continue;
+        if(parsed < 0) {
+            printf("Warning: Skipping line %lld (invalid %s).\n", lineNo, traceFieldName(parsed));
+            continue;
+        }
+        
+        for(p = 0; p < ONLINE_POLICIES; p++) {
+            onlineAccess(&sims[p], page);
+        }
+        if(sims[0].accesses % interval == 0)
+            printStreamSnapshot(sims);
+    }
+    
+    printf("\n========================================\n");
+    printf("     LIVE STREAM SUMMARY (%d frames)\n", frameCount);
+    printf("========================================\n");
+    printf("%-20s\t%s\t%s\t%s\n", "Algorithm", "Faults", "Hits", "Fault%");
+    for(p = 0; p < ONLINE_POLICIES; p++) {
+        onlineSnapshot(&sims[p], &st);
+        printf("%-20s\t%lld\t%lld\t%.2f%%\n", policyName(p), st.faults, st.hits, st.faultRatio);
+        onlineFree(&sims[p]);
+    }
+    printf("========================================\n");
+    return 0;
+}
+
+void liveStreamSimulation() {
+    FILE *fp;
+    char filename[256];
+    int frameCount;
+    long long interval;
+    
+    printf("\n--- Live Stream Simulation ---\n");
+    printf("Enter stream path (file or named pipe): ");
+    scanf("%255s", filename);
+    printf("Enter number of frames: ");
+    scanf("%d", &frameCount);
+    printf("Enter snapshot interval (references): ");
+    scanf("%lld", &interval);
+    
+    if(frameCount < 1) {
+        printf("Invalid! Using default 3 frames.\n");
+        frameCount = 3;
+    }
+    if(interval < 1) {
+        printf("Invalid! Using default interval %d.\n", DEFAULT_SNAPSHOT_INTERVAL);
+        interval = DEFAULT_SNAPSHOT_INTERVAL;
+    }
+    
+    fp = fopen(filename, "r");
+    if(fp == NULL) {
+        printf("Error: Cannot open %s (File not found or permission denied)\n", filename);
+        return;
+    }
+    runLiveStream(fp, frameCount, interval);
+    fclose(fp);
+}
+
+/* vm --stream <frames> [interval]: reads the reference stream from stdin */
+int streamFromCommandLine(int argc, char *argv[]) {
+    int frameCount;
+    long long interval = DEFAULT_SNAPSHOT_INTERVAL;
+    
+    if(argc < 3 || (frameCount = atoi(argv[2])) < 1) {
+        fprintf(stderr, "Usage: %s --stream <frames> [snapshot interval]\n", argv[0]);
+        return 1;
+    }
+    if(argc > 3 && atoll(argv[3]) > 0)
+        interval = atoll(argv[3]);
+    
+    return runLiveStream(stdin, frameCount, interval);
+}
+
+static int segListInit(SegList *l, int capacity) {
+    int i;
+    
+    if(capacity < 1) capacity = 1;
+    l->segmentOf = calloc(capacity, 1);
+    l->prev = malloc(capacity * sizeof(int));
+    l->next = malloc(capacity * sizeof(int));
+    if(l->segmentOf == NULL || l->prev == NULL || l->next == NULL) {
+        free(l->segmentOf);
+        free(l->prev);
+        free(l->next);
+        return 0;
+    }
+    for(i = 0; i < SEGLIST_SEGMENTS; i++) {
+        l->head[i] = l->tail[i] = -1;
+        l->count[i] = 0;
+    }
+    return 1;
+}
+
+static void segListFree(SegList *l) {
+    free(l->segmentOf);
+    free(l->prev);
+    free(l->next);
+    l->segmentOf = NULL;
+    l->prev = l->next = NULL;
+}
+
+static void segListUnlink(SegList *l, int id) {
+    int seg = l->segmentOf[id];
+    
+    if(l->prev[id] != -1) l->next[l->prev[id]] = l->next[id];
+    else l->head[seg] = l->next[id];
+    if(l->next[id] != -1) l->prev[l->next[id]] = l->prev[id];
+    else l->tail[seg] = l->prev[id];
+    l->count[seg]--;
+    l->segmentOf[id] = 0;
+}
+
+static void segListPushFront(SegList *l, int seg, int id) {
+    l->prev[id] = -1;
+    l->next[id] = l->head[seg];
+    if(l->head[seg] != -1) l->prev[l->head[seg]] = id;
+    else l->tail[seg] = id;
+    l->head[seg] = id;
+    l->count[seg]++;
+    l->segmentOf[id] = (unsigned char)seg;
+}
+
+/*
+ * Two-tier memory: a small fast tier (DRAM) in front of a larger slow
+ * tier (CXL/NVM) in front of swap. New pages are placed in DRAM; DRAM
+ * victims are demoted to the slow tier and slow-tier victims go to swap.
+ * Each tier keeps its pages in a list whose tail is the next victim; the
+ * demotion policy decides how a hit reorders the list and the promotion
+ * policy decides when a slow-tier hit moves the page up to DRAM.
+ */
+static void touchLru(TierSim *sim, int tier, int page) {
+    segListUnlink(&sim->tiers, page);
+    segListPushFront(&sim->tiers, tier, page);
+}
+
+static void touchFifo(TierSim *sim, int tier, int page) {
+    (void)sim;
+    (void)tier;
+    (void)page;
+}
+
+static bool promoteAlways(TierSim *sim, int page) {
+    (void)sim;
+    (void)page;
+    return true;
+}
+
+static bool promoteNever(TierSim *sim, int page) {
+    (void)sim;
+    (void)page;
+    return false;
+}
+
+/* Counter halves every decay interval, applied lazily when the page is next seen */
+static bool promoteHotness(TierSim *sim, int page) {
+    unsigned int epoch = (unsigned int)(sim->now / sim->cfg.decayInterval);
+    unsigned int age = epoch - sim->hotEpoch[page];
+    
+    sim->hotness[page] = age >= 32 ? 0 : sim->hotness[page] >> age;
+    sim->hotEpoch[page] = epoch;
+    sim->hotness[page]++;
+    if(sim->hotness[page] >= (unsigned int)sim->cfg.hotThreshold) {
+        sim->hotness[page] = 0;
+        return true;
+    }
+    return false;
+}
+
+const DemotionPolicy demotionPolicies[] = {
+    { "LRU", touchLru },
+    { "FIFO", touchFifo },
+};
+
+const PromotionPolicy promotionPolicies[] = {
+    { "Hotness counter", promoteHotness },
+    { "On every access", promoteAlways },
+    { "Never (fault-in only)", promoteNever },
+};
+
+#define DEMOTION_POLICIES ((int)(sizeof(demotionPolicies) / sizeof(demotionPolicies[0])))
+#define PROMOTION_POLICIES ((int)(sizeof(promotionPolicies) / sizeof(promotionPolicies[0])))
+
+static void makeRoomInSlow(TierSim *sim) {
+    if(sim->tiers.count[TIER_SLOW] >= sim->cfg.slowFrames) {
+        segListUnlink(&sim->tiers, sim->tiers.tail[TIER_SLOW]);
+        sim->stats.swapOuts++;
+    }
+}
+
+static void makeRoomInDram(TierSim *sim) {
+    int victim;
+    
+    if(sim->tiers.count[TIER_DRAM] < sim->cfg.dramFrames)
+        return;
+    
+    victim = sim->tiers.tail[TIER_DRAM];
+    segListUnlink(&sim->tiers, victim);
+    if(sim->cfg.slowFrames > 0) {
+        makeRoomInSlow(sim);
+        segListPushFront(&sim->tiers, TIER_SLOW, victim);
+        sim->stats.demotions++;
+    }
+    else {
+        sim->stats.swapOuts++;
+    }
+}
+
+/* Runs one tier configuration over the trace; returns 0 if out of memory */
+int simulateTiers(const Trace *t, const TierConfig *cfg, TierStats *out) {
+    TierSim sim;
+    int i;
+    
+    memset(&sim, 0, sizeof(sim));
+    sim.cfg = *cfg;
+    sim.demotion = &demotionPolicies[cfg->demotionPolicy];
+    sim.promotion = &promotionPolicies[cfg->promotionPolicy];
+    if(!segListInit(&sim.tiers, t->distinctPages))
+        return 0;
+    sim.hotness = calloc(t->distinctPages, sizeof(unsigned int));
+    sim.hotEpoch = calloc(t->distinctPages, sizeof(unsigned int));
+    if(sim.hotness == NULL || sim.hotEpoch == NULL) {
+        segListFree(&sim.tiers);
+        free(sim.hotness);
+        free(sim.hotEpoch);
+        return 0;
+    }
+    
+    for(i = 0; i < t->length; i++) {
+        int page = t->refs[i];
+        
+        sim.now = i;
+        switch(sim.tiers.segmentOf[page]) {
+            case TIER_DRAM:
+                sim.stats.dramHits++;
+                sim.stats.totalLatency += cfg->dramLatency;
+                sim.demotion->touch(&sim, TIER_DRAM, page);
+                break;
+                
+            case TIER_SLOW:
+                sim.stats.slowHits++;
+                sim.stats.totalLatency += cfg->slowLatency;
+                if(sim.promotion->shouldPromote(&sim, page)) {
+                    segListUnlink(&sim.tiers, page);
+                    makeRoomInDram(&sim);
+                    segListPushFront(&sim.tiers, TIER_DRAM, page);
+                    sim.stats.promotions++;
+                }
+                else {
+                    sim.demotion->touch(&sim, TIER_SLOW, page);
+                }
+                break;
+                
+            default:
+                sim.stats.faults++;
+                sim.stats.totalLatency += cfg->swapLatency;
+                makeRoomInDram(&sim);
+                segListPushFront(&sim.tiers, TIER_DRAM, page);
+                break;
+        }
+    }
+    sim.stats.accesses = t->length;
+    *out = sim.stats;
+    
+    segListFree(&sim.tiers);
+    free(sim.hotness);
+    free(sim.hotEpoch);
+    return 1;
+}
+
+typedef struct {
+    const Trace *trace;
+    TierConfig base;
+    const double *scales;
+    TierStats *results;
+    int *ok;
+} TierSweepJob;
+
+static void tierSweepTask(void *ctx, int index) {
+    TierSweepJob *job = ctx;
+    TierConfig cfg = job->base;
+    
+    cfg.dramFrames = (int)(job->base.dramFrames * job->scales[index] + 0.5);
+    if(cfg.dramFrames < 1) cfg.dramFrames = 1;
+    job->ok[index] = simulateTiers(job->trace, &cfg, &job->results[index]);
+}
+
+static void printTierStats(const TierConfig *cfg, const TierStats *st) {
+    long long dramMisses = st->accesses - st->dramHits;
+    
+    printf("\n========================================\n");
+    printf("      TIERED MEMORY STATISTICS\n");
+    printf("========================================\n");
+    printf("Demotion / Promotion : %s / %s\n",
+           demotionPolicies[cfg->demotionPolicy].name, promotionPolicies[cfg->promotionPolicy].name);
+    printf("Total References     : %lld\n", st->accesses);
+    printf("DRAM Tier Hits       : %lld (%.2f%%)\n", st->dramHits, (float)st->dramHits / st->accesses * 100);
+    printf("Slow Tier Hits       : %lld (%.2f%% of all, %.2f%% of DRAM misses)\n", st->slowHits,
+           (float)st->slowHits / st->accesses * 100,
+           dramMisses ? (float)st->slowHits / dramMisses * 100 : 0.0f);
+    printf("Page Faults (swap)   : %lld (%.2f%%)\n", st->faults, (float)st->faults / st->accesses * 100);
+    printf("Promotions           : %lld\n", st->promotions);
+    printf("Demotions            : %lld\n", st->demotions);
+    printf("Swap-outs            : %lld\n", st->swapOuts);
+    printf("Avg Access Latency   : %.2f ns\n", st->totalLatency / st->accesses);
+    printf("========================================\n");
+}
+
+void tieredMemorySimulation() {
+    Trace t;
+    TierConfig cfg;
+    TierStats st;
+    TierSweepJob job;
+    double scales[] = { 0.25, 0.5, 0.75, 1.0, 1.5, 2.0 };
+    int numScales = sizeof(scales) / sizeof(scales[0]);
+    TierStats results[sizeof(scales) / sizeof(scales[0])];
+    int ok[sizeof(scales) / sizeof(scales[0])];
+    int i;
+    
+    if(!getAnalysisTrace(&t)) {
+        printf("\nError: No input data! Please enter data or load a trace first.\n");
+        return;
+    }
+    
+    printf("\n--- Tiered Memory Simulation ---\n");
+    printf("Trace: %d references, %d distinct pages\n", t.length, t.distinctPages);
+    printf("Enter DRAM tier frames: ");
+    scanf("%d", &cfg.dramFrames);
+    printf("Enter slow tier frames (0 for none): ");
+    scanf("%d", &cfg.slowFrames);
+    printf("Enter DRAM / slow tier / swap latency in ns (e.g. 100 350 100000): ");
+    scanf("%lf %lf %lf", &cfg.dramLatency, &cfg.slowLatency, &cfg.swapLatency);
+    
+    if(cfg.dramFrames < 1) {
+        printf("Invalid! Using default 3 DRAM frames.\n");
+        cfg.dramFrames = 3;
+    }
+    if(cfg.slowFrames < 0) {
+        printf("Invalid! Using no slow tier.\n");
+        cfg.slowFrames = 0;
+    }
+    if(cfg.dramLatency < 0 || cfg.slowLatency < 0 || cfg.swapLatency < 0) {
+        printf("Invalid latencies! Using defaults %.0f / %.0f / %.0f ns.\n",
+               DEFAULT_DRAM_NS, DEFAULT_SLOW_NS, DEFAULT_SWAP_NS);
+        cfg.dramLatency = DEFAULT_DRAM_NS;
+        cfg.slowLatency = DEFAULT_SLOW_NS;
+        cfg.swapLatency = DEFAULT_SWAP_NS;
+    }
+    
+    printf("\nDemotion policy:\n");
+    for(i = 0; i < DEMOTION_POLICIES; i++) printf("%d. %s\n", i + 1, demotionPolicies[i].name);
+    printf("Enter choice: ");
+    scanf("%d", &cfg.demotionPolicy);
+    cfg.demotionPolicy--;
+    if(cfg.demotionPolicy < 0 || cfg.demotionPolicy >= DEMOTION_POLICIES) {
+        printf("Invalid! Using LRU.\n");
+        cfg.demotionPolicy = 0;
+    }
+    
+    printf("\nPromotion policy:\n");
+    for(i = 0; i < PROMOTION_POLICIES; i++) printf("%d. %s\n", i + 1, promotionPolicies[i].name);
+    printf("Enter choice: ");
+    scanf("%d", &cfg.promotionPolicy);
+    cfg.promotionPolicy--;
+    if(cfg.promotionPolicy < 0 || cfg.promotionPolicy >= PROMOTION_POLICIES) {
+        printf("Invalid! Using hotness counter.\n");
+        cfg.promotionPolicy = 0;
+    }
+    
+    cfg.hotThreshold = DEFAULT_HOT_THRESHOLD;
+    cfg.decayInterval = DEFAULT_DECAY_INTERVAL;
+    if(cfg.promotionPolicy == 0) {
+        printf("Enter hotness threshold and decay interval (e.g. %d %d): ", DEFAULT_HOT_THRESHOLD, DEFAULT_DECAY_INTERVAL);
+        scanf("%d %d", &cfg.hotThreshold, &cfg.decayInterval);
+        if(cfg.hotThreshold < 1 || cfg.decayInterval < 1) {
+            printf("Invalid! Using defaults.\n");
+            cfg.hotThreshold = DEFAULT_HOT_THRESHOLD;
+            cfg.decayInterval = DEFAULT_DECAY_INTERVAL;
+        }
+    }
+    
+    if(!simulateTiers(&t, &cfg, &st)) {
+        printf("Error: Out of memory.\n");
+        releaseTrace(&t);
+        return;
+    }
+    printTierStats(&cfg, &st);
+    
+    /* DRAM sizing: same slow tier and policies, DRAM scaled around the chosen size */
+    job.trace = &t;
+    job.base = cfg;
+    job.scales = scales;
+    job.results = results;
+    job.ok = ok;
+    runParallel(numScales, tierSweepTask, &job);
+    
+    printf("\nDRAM SIZING (slow tier fixed at %d frames):\n", cfg.slowFrames);
+    printf("%10s %10s %10s %10s %14s\n", "DRAM", "DRAM hit%", "Slow hit%", "Fault%", "Avg ns");
+    printf("---------- ---------- ---------- ---------- --------------\n");
+    for(i = 0; i < numScales; i++) {
+        int frames = (int)(cfg.dramFrames * scales[i] + 0.5);
+        if(frames < 1) frames = 1;
+        if(!ok[i]) {
+            printf("%10d Out of memory\n", frames);
+            continue;
+        }
+        printf("%10d %9.2f%% %9.2f%% %9.2f%% %14.2f\n", frames,
+               (float)results[i].dramHits / results[i].accesses * 100,
+               (float)results[i].slowHits / results[i].accesses * 100,
+               (float)results[i].faults / results[i].accesses * 100,
+               results[i].totalLatency / results[i].accesses);
+    }
+    
+    releaseTrace(&t);
+}
+
+/*
+ * Optimal replacement with explicit state so it can be checkpointed: the
+ * frames are kept in a max-heap keyed on the position of their next use
+ * (INT_MAX if never used again), taken from a next-use table built once
+ * per trace. Ties only happen between pages that are never used again,
+ * so the fault counts equal those of optimalAlgorithm().
+ */
+int *buildNextUse(const Trace *t) {
+    int *nextUse = malloc(t->length * sizeof(int));
+    int *upcoming = malloc(t->distinctPages * sizeof(int));
+    int i;
+    
+    if(nextUse == NULL || upcoming == NULL) {
+        free(nextUse);
+        free(upcoming);
+        return NULL;
+    }
+    for(i = 0; i < t->distinctPages; i++) {
+        upcoming[i] = INT_MAX;
+    }
+    for(i = t->length - 1; i >= 0; i--) {
+        nextUse[i] = upcoming[t->refs[i]];
+        upcoming[t->refs[i]] = i;
+    }
+    free(upcoming);
+    return nextUse;
+}
+
+static void indexedHeapFree(IndexedHeap *h) {
+    free(h->items);
+    free(h->pos);
+    free(h->key);
+    h->items = h->pos = NULL;
+    h->key = NULL;
+}
+
+static int indexedHeapInit(IndexedHeap *h, int capacity) {
+    int i;
+    
+    if(capacity < 1) capacity = 1;
+    h->items = malloc(capacity * sizeof(int));
+    h->pos = malloc(capacity * sizeof(int));
+    h->key = malloc(capacity * sizeof(double));
+    h->size = 0;
+    if(h->items == NULL || h->pos == NULL || h->key == NULL) {
+        indexedHeapFree(h);
+        return 0;
+    }
+    for(i = 0; i < capacity; i++) {
+        h->pos[i] = -1;
+    }
+    return 1;
+}
+
+static void indexedHeapSwap(IndexedHeap *h, int a, int b) {
+    int id = h->items[a];
+    h->items[a] = h->items[b];
+    h->items[b] = id;
+    h->pos[h->items[a]] = a;
+    h->pos[h->items[b]] = b;
+}
+
+static void indexedHeapUp(IndexedHeap *h, int i) {
+    while(i > 0) {
+        int parent = (i - 1) / 2;
+        if(h->key[h->items[parent]] <= h->key[h->items[i]])
+            break;
+        indexedHeapSwap(h, i, parent);
+        i = parent;
+    }
+}
+
+static void indexedHeapDown(IndexedHeap *h, int i) {
+    while(1) {
+        int smallest = i, child;
+        for(child = 2 * i + 1; child <= 2 * i + 2 && child < h->size; child++) {
+            if(h->key[h->items[child]] < h->key[h->items[smallest]])
+                smallest = child;
+        }
+        if(smallest == i)
+            break;
+        indexedHeapSwap(h, i, smallest);
+        i = smallest;
+    }
+}
+
+/* Inserts id, or moves it if it is already in the heap */
+static void indexedHeapSet(IndexedHeap *h, int id, double key) {
+    h->key[id] = key;
+    if(h->pos[id] == -1) {
+        h->items[h->size] = id;
+        h->pos[id] = h->size++;
+    }
+    indexedHeapUp(h, h->pos[id]);
+    indexedHeapDown(h, h->pos[id]);
+}
+
+static void indexedHeapRemove(IndexedHeap *h, int id) {
+    int i = h->pos[id];
+    
+    h->pos[id] = -1;
+    h->size--;
+    if(i != h->size) {
+        h->items[i] = h->items[h->size];
+        h->pos[h->items[i]] = i;
+        indexedHeapUp(h, i);
+        indexedHeapDown(h, h->pos[h->items[i]]);
+    }
+}
+
+int optimalInit(OptimalSim *sim, int frameCount, int distinctPages) {
+    int i;
+    
+    memset(sim, 0, sizeof(*sim));
+    sim->frameCount = frameCount;
+    sim->distinctPages = distinctPages;
+    sim->framePage = malloc(frameCount * sizeof(int));
+    sim->slotOf = malloc(distinctPages * sizeof(int));
+    if(sim->framePage == NULL || sim->slotOf == NULL || !indexedHeapInit(&sim->heap, frameCount)) {
+        optimalFree(sim);
+        return 0;
+    }
+    for(i = 0; i < distinctPages; i++) {
+        sim->slotOf[i] = -1;
+    }
+    return 1;
+}
+
+void optimalFree(OptimalSim *sim) {
+    free(sim->framePage);
+    free(sim->slotOf);
+    indexedHeapFree(&sim->heap);
+    sim->framePage = sim->slotOf = NULL;
+}
+
+/* Reference number `position` of the trace, with nextUse from buildNextUse() */
+bool optimalAccess(OptimalSim *sim, const int *nextUse, int position, int page) {
+    int slot = sim->slotOf[page];
+    
+    sim->accesses++;
+    if(slot != -1) {
+        sim->hits++;
+        indexedHeapSet(&sim->heap, slot, -(double)nextUse[position]);
+        return true;
+    }
+    
+    sim->faults++;
+    if(sim->heap.size < sim->frameCount) {
+        slot = sim->heap.size;
+    }
+    else {
+        slot = sim->heap.items[0];
+        sim->slotOf[sim->framePage[slot]] = -1;
+    }
+    
+    sim->framePage[slot] = page;
+    sim->slotOf[page] = slot;
+    indexedHeapSet(&sim->heap, slot, -(double)nextUse[position]);
+    return false;
+}
+
+/*
+ * Predictor for predictiveAlgorithm() and PredictiveSim. Memory is fixed by
+ * the table sizes and the frame count. Sampling keeps OPTgen at most
+ * OPTGEN_SAMPLED_FRAMES frames, so a sampled access walks at most
+ * 2 * OPTGEN_SAMPLED_FRAMES * OPTGEN_WINDOW_MULT entries; the bucket lists
+ * make hits, inserts and victim selection constant time.
+ */
+int predictorInit(Predictor *p, int frameCount) {
+    int i, shift = 0;
+    
+    while(shift < 20 && (frameCount >> shift) > OPTGEN_SAMPLED_FRAMES) {
+        shift++;
+    }
+    p->frameCount = frameCount;
+    p->sampleMask = (1u << shift) - 1;
+    p->sampledFrames = (frameCount + (1 << shift) / 2) >> shift;
+    p->window = p->sampledFrames * OPTGEN_WINDOW_MULT;
+    p->now = 0;
+    p->epoch = 0;
+    p->counters = malloc((size_t)1 << PREDICTOR_BITS);
+    p->occupancy = calloc(p->window, sizeof(int));
+    p->samplerPage = malloc(sizeof(uint64_t) << SAMPLER_BITS);
+    p->samplerTime = malloc(sizeof(long long) << SAMPLER_BITS);
+    p->stamp = malloc(sizeof(long long) * frameCount);
+    p->prev = malloc(sizeof(int) * frameCount);
+    p->next = malloc(sizeof(int) * frameCount);
+    if(p->counters == NULL || p->occupancy == NULL || p->samplerPage == NULL ||
+       p->samplerTime == NULL || p->stamp == NULL || p->prev == NULL || p->next == NULL) {
+        predictorFree(p);
+        return 0;
+    }
+    memset(p->counters, PREDICTOR_THRESHOLD, (size_t)1 << PREDICTOR_BITS);
+    memset(p->samplerPage, 0, sizeof(uint64_t) << SAMPLER_BITS);
+    for(i = 0; i < (1 << SAMPLER_BITS); i++) {
+        p->samplerTime[i] = -1;
+    }
+    for(i = 0; i <= RRPV_MAX; i++) {
+        p->head[i] = p->tail[i] = -1;
+    }
+    return 1;
+}
+
+void predictorFree(Predictor *p) {
+    free(p->counters);
+    free(p->occupancy);
+    free(p->samplerPage);
+    free(p->samplerTime);
+    free(p->stamp);
+    free(p->prev);
+    free(p->next);
+    p->counters = NULL;
+    p->occupancy = NULL;
+    p->samplerPage = NULL;
+    p->samplerTime = NULL;
+    p->stamp = NULL;
+    p->prev = p->next = NULL;
+}
+
+/*
+ * Counters are shared by 2^PREDICTOR_REGION_SHIFT neighbouring pages (original
+ * page numbers). Hashing single pages spreads tens of pages of unrelated
+ * behaviour over each counter; a region usually holds pages of one kind.
+ */
+static inline unsigned char *predictorCounter(Predictor *p, uint64_t page) {
+    return &p->counters[hashPage(page >> PREDICTOR_REGION_SHIFT, PREDICTOR_BITS)];
+}
+
+static void predictorTrain(Predictor *p, uint64_t page, bool friendly) {
+    unsigned char *c = predictorCounter(p, page);
+    
+    if(friendly && *c < PREDICTOR_MAX)
+        (*c)++;
+    else if(!friendly && *c > 0)
+        (*c)--;
+}
+
+/*
+ * One OPTgen step for a sampled page: occupancy[q] counts sampled pages OPT
+ * would keep at time q. A reuse of a page last seen at time t0 would have
+ * hit under OPT only if every time in [t0, now) still has a free frame; if
+ * so, the page claims those frames. Reuses older than the window are not
+ * labelled: time distance says little about OPT on skewed traces. Returns
+ * the updated prediction.
+ */
+bool predictorObserve(Predictor *p, uint64_t page) {
+    unsigned int h = hashPage(page, 32);
+    unsigned int e = h >> (32 - SAMPLER_BITS);
+    int slot = (int)(p->now % p->window);
+    
+    if(h & p->sampleMask)
+        return *predictorCounter(p, page) >= PREDICTOR_THRESHOLD;
+    p->occupancy[slot] = 0;
+    if(p->samplerTime[e] >= 0 && p->samplerPage[e] == page &&
+       p->now - p->samplerTime[e] < p->window) {
+        int distance = (int)(p->now - p->samplerTime[e]);
+        bool fits = true;
+        int start = (int)(p->samplerTime[e] % p->window);
+        int q, k;
+        
+        for(q = start, k = 0; fits && k < distance; k++) {
+            if(p->occupancy[q] >= p->sampledFrames)
+                fits = false;
+            if(++q == p->window)
+                q = 0;
+        }
+        if(fits) {
+            for(q = start, k = 0; k < distance; k++) {
+                p->occupancy[q]++;
+                if(++q == p->window)
+                    q = 0;
+            }
+        }
+        predictorTrain(p, page, fits);
+    }
+    p->samplerPage[e] = page;
+    p->samplerTime[e] = p->now;
+    p->now++;
+    return *predictorCounter(p, page) >= PREDICTOR_THRESHOLD;
+}
+
+/* Called when a page predicted friendly has to be evicted anyway */
+void predictorDetrain(Predictor *p, uint64_t page) {
+    predictorTrain(p, page, false);
+}
+
+/* Current RRPV of a frame in use */
+int predictorRrpv(const Predictor *p, int frame) {
+    long long age;
+    
+    if(p->stamp[frame] < 0)
+        return RRPV_MAX;
+    age = p->epoch - p->stamp[frame];
+    return age < RRPV_MAX - 1 ? (int)age : RRPV_MAX - 1;
+}
+
+/* Bucket list currently holding frames of the given RRPV */
+static inline int predictorBucket(const Predictor *p, int rrpv) {
+    if(rrpv >= RRPV_MAX - 1)
+        return rrpv;
+    return (int)((p->epoch + AGING_BUCKETS - rrpv) % AGING_BUCKETS);
+}
+
+static void predictorUnlink(Predictor *p, int frame) {
+    int b = predictorBucket(p, predictorRrpv(p, frame));
+    
+    if(p->prev[frame] != -1)
+        p->next[p->prev[frame]] = p->next[frame];
+    else
+        p->head[b] = p->next[frame];
+    if(p->next[frame] != -1)
+        p->prev[p->next[frame]] = p->prev[frame];
+    else
+        p->tail[b] = p->prev[frame];
+}
+
+/* Links a frame as most recently used, stamped friendly or averse */
+static void predictorPush(Predictor *p, int frame, bool friendly) {
+    int b;
+    
+    p->stamp[frame] = friendly ? p->epoch : -1;
+    b = predictorBucket(p, predictorRrpv(p, frame));
+    p->prev[frame] = -1;
+    p->next[frame] = p->head[b];
+    if(p->head[b] != -1)
+        p->prev[p->head[b]] = frame;
+    else
+        p->tail[b] = frame;
+    p->head[b] = frame;
+}
+
+/*
+ * Unlinks and returns the victim: the least recently used frame of the
+ * highest non-empty RRPV, so averse frames go before any friendly one.
+ */
+int predictorVictim(Predictor *p) {
+    int rrpv, victim = 0;
+    
+    for(rrpv = RRPV_MAX; rrpv >= 0; rrpv--) {
+        victim = p->tail[predictorBucket(p, rrpv)];
+        if(victim != -1)
+            break;
+    }
+    predictorUnlink(p, victim);
+    return victim;
+}
+
+/* OPTgen never labels unsampled pages, so a hit is their friendly training */
+void predictorHit(Predictor *p, int frame, uint64_t page, bool friendly) {
+    if(hashPage(page, 32) & p->sampleMask)
+        predictorTrain(p, page, true);
+    predictorUnlink(p, frame);
+    predictorPush(p, frame, friendly);
+}
+
+/*
+ * For a frame not in any bucket (new or just returned by predictorVictim).
+ * A friendly insert ages every other friendly frame by one: the epoch moves,
+ * the RRPV RRPV_MAX - 2 list joins the front of the capped one, and its
+ * ring slot becomes the new RRPV 0 list.
+ */
+void predictorInsert(Predictor *p, int frame, bool friendly) {
+    if(friendly) {
+        int oldest = predictorBucket(p, RRPV_MAX - 2);
+        int capped = RRPV_MAX - 1;
+        
+        if(p->head[oldest] != -1) {
+            if(p->head[capped] != -1) {
+                p->next[p->tail[oldest]] = p->head[capped];
+                p->prev[p->head[capped]] = p->tail[oldest];
+            }
+            else {
+                p->tail[capped] = p->tail[oldest];
+            }
+            p->head[capped] = p->head[oldest];
+            p->head[oldest] = p->tail[oldest] = -1;
+        }
+        p->epoch++;
+    }
+    predictorPush(p, frame, friendly);
+}
+
+int predictiveInit(PredictiveSim *sim, int frameCount, int distinctPages) {
+    int i;
+    
+    sim->frameCount = frameCount;
+    sim->distinctPages = distinctPages;
+    sim->filled = 0;
+    sim->accesses = sim->hits = sim->faults = 0;
+    sim->framePage = malloc(sizeof(int) * frameCount);
+    sim->slotOf = malloc(sizeof(int) * (distinctPages > 0 ? distinctPages : 1));
+    if(sim->framePage == NULL || sim->slotOf == NULL || !predictorInit(&sim->predictor, frameCount)) {
+        free(sim->framePage);
+        free(sim->slotOf);
+        sim->framePage = sim->slotOf = NULL;
+        return 0;
+    }
+    for(i = 0; i < distinctPages; i++) {
+        sim->slotOf[i] = -1;
+    }
+    return 1;
+}
+
+void predictiveFree(PredictiveSim *sim) {
+    predictorFree(&sim->predictor);
+    free(sim->framePage);
+    free(sim->slotOf);
+    sim->framePage = sim->slotOf = NULL;
+}
+
+/*
+ * Same policy as predictiveAlgorithm(), without printing or history.
+ * The predictor hashes original page numbers (pageIds, NULL if the dense
+ * ids are the page numbers) so results match the interactive run.
+ */
+bool predictiveAccess(PredictiveSim *sim, const uint64_t *pageIds, int page) {
+    Predictor *p = &sim->predictor;
+    bool friendly = predictorObserve(p, pageIds != NULL ? pageIds[page] : (uint64_t)page);
+    int slot = sim->slotOf[page];
+    
+    sim->accesses++;
+    if(slot != -1) {
+        sim->hits++;
+        predictorHit(p, slot, pageIds != NULL ? pageIds[page] : (uint64_t)page, friendly);
+        return true;
+    }
+    
+    sim->faults++;
+    if(sim->filled < sim->frameCount) {
+        slot = sim->filled++;
+    }
+    else {
+        int victimPage;
+        
+        slot = predictorVictim(p);
+        victimPage = sim->framePage[slot];
+        if(predictorRrpv(p, slot) < RRPV_MAX)
+            predictorDetrain(p, pageIds != NULL ? pageIds[victimPage] : (uint64_t)victimPage);
+        sim->slotOf[victimPage] = -1;
+    }
+    sim->framePage[slot] = page;
+    sim->slotOf[page] = slot;
+    predictorInsert(p, slot, friendly);
+    return false;
+}
+
+/*
+ * Checkpoints are native-endian binary files meant to be resumed by the
+ * same build: a header identifying the trace, the trace offset, then the
+ * complete state of each policy. Derived tables (the OPT page -> slot map
+ * and heap positions) are rebuilt on load instead of stored.
+ */
+static void ckptPut(CkptBuffer *b, const void *data, size_t size) {
+    if(!b->ok)
+        return;
+    if(b->length + size > b->capacity) {
+        size_t capacity = b->capacity ? b->capacity : 4096;
+        unsigned char *grown;
+        while(capacity < b->length + size) capacity *= 2;
+        grown = realloc(b->data, capacity);
+        if(grown == NULL) {
+            b->ok = false;
+            return;
+        }
+        b->data = grown;
+        b->capacity = capacity;
+    }
+    memcpy(b->data + b->length, data, size);
+    b->length += size;
+}
+
+static void ckptGet(CkptBuffer *b, void *data, size_t size) {
+    if(!b->ok || b->length + size > b->capacity) {
+        b->ok = false;
+        memset(data, 0, size);
+        return;
+    }
+    memcpy(data, b->data + b->length, size);
+    b->length += size;
+}
+
+#define CKPT_PUT(b, x) ckptPut((b), &(x), sizeof(x))
+#define CKPT_GET(b, x) ckptGet((b), &(x), sizeof(x))
+
+uint64_t traceFingerprint(const Trace *t) {
+    uint64_t h = 1469598103934665603ULL;
+    int i;
+    
+    for(i = 0; i < t->length; i++) {
+        h ^= (uint64_t)t->refs[i];
+        h *= 1099511628211ULL;
+    }
+    /* Predictive state is keyed on original page numbers */
+    for(i = 0; t->pageIds != NULL && i < t->distinctPages; i++) {
+        h ^= t->pageIds[i];
+        h *= 1099511628211ULL;
+    }
+    return h ^ ((uint64_t)t->length << 32) ^ (uint64_t)t->distinctPages;
+}
+
+static void saveOnlineSim(CkptBuffer *b, const OnlineSim *sim) {
+    int size = 1 << sim->hashBits;
+    
+    CKPT_PUT(b, sim->policy);
+    CKPT_PUT(b, sim->frameCount);
+    CKPT_PUT(b, sim->hashBits);
+    CKPT_PUT(b, sim->lruHead);
+    CKPT_PUT(b, sim->lruTail);
+    CKPT_PUT(b, sim->fifoPosition);
+    CKPT_PUT(b, sim->filled);
+    CKPT_PUT(b, sim->hand);
+    CKPT_PUT(b, sim->accesses);
+    CKPT_PUT(b, sim->hits);
+    CKPT_PUT(b, sim->faults);
+    CKPT_PUT(b, sim->windowAccesses);
+    CKPT_PUT(b, sim->windowFaults);
+    ckptPut(b, sim->framePage, sim->filled * sizeof(uint64_t));
+    ckptPut(b, sim->hashKeys, size * sizeof(uint64_t));
+    ckptPut(b, sim->hashSlots, size * sizeof(int));
+    ckptPut(b, sim->prev, sim->filled * sizeof(int));
+    ckptPut(b, sim->next, sim->filled * sizeof(int));
+    ckptPut(b, sim->referenceBits, (sim->frameCount + 63) / 64 * sizeof(uint64_t));
+}
+
+/*
+ * A checkpoint is trusted only as far as onlineAccess() will index with
+ * it: positions must lie inside the frames, the LRU list must visit every
+ * filled frame once from head to tail, and every resident page must be
+ * found in the hash table at its own frame with nothing else stored.
+ */
+static bool onlineSimValid(const OnlineSim *sim) {
+    int size = 1 << sim->hashBits;
+    int filled = sim->filled;
+    int used = 0, visited = 0, prevSlot = -1, slot, i;
+    
+    if(sim->fifoPosition < 0 || sim->fifoPosition >= sim->frameCount ||
+       sim->hand < 0 || sim->hand >= sim->frameCount)
+        return false;
+    
+    if(sim->policy != POLICY_LRU) {
+        if(sim->lruHead != -1 || sim->lruTail != -1)
+            return false;
+    }
+    else {
+        if(sim->lruHead < -1 || sim->lruHead >= filled || sim->lruTail < -1 || sim->lruTail >= filled)
+            return false;
+        for(slot = sim->lruHead; slot != -1; slot = sim->next[slot]) {
+            if(++visited > filled || sim->prev[slot] != prevSlot ||
+               sim->next[slot] < -1 || sim->next[slot] >= filled)
+                return false;
+            prevSlot = slot;
+        }
+        if(visited != filled || prevSlot != sim->lruTail)
+            return false;
+    }
+    
+    for(i = 0; i < size; i++) {
+        if(sim->hashSlots[i] == -1)
+            continue;
+        if(sim->hashSlots[i] < 0 || sim->hashSlots[i] >= filled)
+            return false;
+        used++;
+    }
+    if(used != filled)
+        return false;
+    for(i = 0; i < filled; i++) {
+        if(onlineLookup(sim, sim->framePage[i]) != i)
+            return false;
+    }
+    return true;
+}
+
+/* Fails unless the stored policy and frame count are the expected ones */
+static bool loadOnlineSim(CkptBuffer *b, OnlineSim *sim, int expectedPolicy, int expectedFrames) {
+    int policy, frameCount, hashBits, size;
+    
+    CKPT_GET(b, policy);
+    CKPT_GET(b, frameCount);
+    CKPT_GET(b, hashBits);
+    if(!b->ok || policy != expectedPolicy || frameCount != expectedFrames || !onlineInit(sim, policy, frameCount))
+        return false;
+    if(hashBits != sim->hashBits) {
+        onlineFree(sim);
+        return false;
+    }
+    size = 1 << sim->hashBits;
+    
+    CKPT_GET(b, sim->lruHead);
+    CKPT_GET(b, sim->lruTail);
+    CKPT_GET(b, sim->fifoPosition);
+    CKPT_GET(b, sim->filled);
+    CKPT_GET(b, sim->hand);
+    CKPT_GET(b, sim->accesses);
+    CKPT_GET(b, sim->hits);
+    CKPT_GET(b, sim->faults);
+    CKPT_GET(b, sim->windowAccesses);
+    CKPT_GET(b, sim->windowFaults);
+    if(!b->ok || sim->filled < 0 || sim->filled > frameCount) {
+        onlineFree(sim);
+        return false;
+    }
+    ckptGet(b, sim->framePage, sim->filled * sizeof(uint64_t));
+    ckptGet(b, sim->hashKeys, size * sizeof(uint64_t));
+    ckptGet(b, sim->hashSlots, size * sizeof(int));
+    ckptGet(b, sim->prev, sim->filled * sizeof(int));
+    ckptGet(b, sim->next, sim->filled * sizeof(int));
+    ckptGet(b, sim->referenceBits, (sim->frameCount + 63) / 64 * sizeof(uint64_t));
+    if(!b->ok || !onlineSimValid(sim)) {
+        onlineFree(sim);
+        return false;
+    }
+    return true;
+}
+
+static void saveOptimalSim(CkptBuffer *b, const OptimalSim *sim) {
+    CKPT_PUT(b, sim->frameCount);
+    CKPT_PUT(b, sim->heap.size);
+    CKPT_PUT(b, sim->accesses);
+    CKPT_PUT(b, sim->hits);
+    CKPT_PUT(b, sim->faults);
+    ckptPut(b, sim->framePage, sim->heap.size * sizeof(int));
+    ckptPut(b, sim->heap.items, sim->heap.size * sizeof(int));
+    ckptPut(b, sim->heap.key, sim->heap.size * sizeof(double));
+}
+
+static bool loadOptimalSim(CkptBuffer *b, OptimalSim *sim, int expectedFrames, int distinctPages) {
+    IndexedHeap *h = &sim->heap;
+    int frameCount, i;
+    
+    CKPT_GET(b, frameCount);
+    if(!b->ok || frameCount != expectedFrames || !optimalInit(sim, frameCount, distinctPages))
+        return false;
+    
+    CKPT_GET(b, h->size);
+    CKPT_GET(b, sim->accesses);
+    CKPT_GET(b, sim->hits);
+    CKPT_GET(b, sim->faults);
+    if(!b->ok || h->size < 0 || h->size > frameCount) {
+        optimalFree(sim);
+        return false;
+    }
+    ckptGet(b, sim->framePage, h->size * sizeof(int));
+    ckptGet(b, h->items, h->size * sizeof(int));
+    ckptGet(b, h->key, h->size * sizeof(double));
+    if(!b->ok) {
+        optimalFree(sim);
+        return false;
+    }
+    
+    /* Pages and heap entries must be distinct, keys negated positions and the heap ordered */
+    for(i = 0; i < h->size; i++) {
+        if(sim->framePage[i] < 0 || sim->framePage[i] >= distinctPages ||
+           h->items[i] < 0 || h->items[i] >= h->size ||
+           sim->slotOf[sim->framePage[i]] != -1 || h->pos[h->items[i]] != -1 ||
+           !(h->key[i] >= -(double)INT_MAX && h->key[i] <= 0) ||
+           (i > 0 && h->key[h->items[(i - 1) / 2]] > h->key[h->items[i]])) {
+            optimalFree(sim);
+            return false;
+        }
+        sim->slotOf[sim->framePage[i]] = i;
+        h->pos[h->items[i]] = i;
+    }
+    return true;
+}
+
+static void savePredictiveSim(CkptBuffer *b, const PredictiveSim *sim) {
+    const Predictor *p = &sim->predictor;
+    
+    CKPT_PUT(b, sim->frameCount);
+    CKPT_PUT(b, sim->filled);
+    CKPT_PUT(b, sim->accesses);
+    CKPT_PUT(b, sim->hits);
+    CKPT_PUT(b, sim->faults);
+    CKPT_PUT(b, p->now);
+    CKPT_PUT(b, p->epoch);
+    ckptPut(b, p->head, sizeof(p->head));
+    ckptPut(b, p->tail, sizeof(p->tail));
+    ckptPut(b, p->counters, (size_t)1 << PREDICTOR_BITS);
+    ckptPut(b, p->occupancy, p->window * sizeof(int));
+    ckptPut(b, p->samplerPage, sizeof(uint64_t) << SAMPLER_BITS);
+    ckptPut(b, p->samplerTime, sizeof(long long) << SAMPLER_BITS);
+    ckptPut(b, sim->framePage, sim->filled * sizeof(int));
+    ckptPut(b, p->stamp, sim->filled * sizeof(long long));
+    ckptPut(b, p->prev, sim->filled * sizeof(int));
+    ckptPut(b, p->next, sim->filled * sizeof(int));
+}
+
+/*
+ * Every frame in use must sit exactly once in the bucket its stamp maps to,
+ * with consistent links; tables must hold values the predictor can produce.
+ */
+static bool predictiveSimValid(PredictiveSim *sim) {
+    Predictor *p = &sim->predictor;
+    int filled = sim->filled, visited = 0, i, bucket;
+    
+    if(p->now < 0 || p->epoch < 0)
+        return false;
+    for(i = 0; i < (1 << PREDICTOR_BITS); i++) {
+        if(p->counters[i] > PREDICTOR_MAX)
+            return false;
+    }
+    for(i = 0; i < p->window; i++) {
+        if(p->occupancy[i] < 0 || p->occupancy[i] > p->sampledFrames)
+            return false;
+    }
+    for(i = 0; i < (1 << SAMPLER_BITS); i++) {
+        if(p->samplerTime[i] < -1 || p->samplerTime[i] >= p->now)
+            return false;
+    }
+    for(i = 0; i < filled; i++) {
+        if(sim->framePage[i] < 0 || sim->framePage[i] >= sim->distinctPages ||
+           sim->slotOf[sim->framePage[i]] != -1 || p->stamp[i] < -1 || p->stamp[i] > p->epoch)
+            return false;
+        sim->slotOf[sim->framePage[i]] = i;
+    }
+    for(bucket = 0; bucket <= RRPV_MAX; bucket++) {
+        int frame, prevFrame = -1;
+        
+        if(p->head[bucket] < -1 || p->head[bucket] >= filled)
+            return false;
+        for(frame = p->head[bucket]; frame != -1; frame = p->next[frame]) {
+            if(++visited > filled || p->prev[frame] != prevFrame ||
+               p->next[frame] < -1 || p->next[frame] >= filled ||
+               predictorBucket(p, predictorRrpv(p, frame)) != bucket)
+                return false;
+            prevFrame = frame;
+        }
+        if(prevFrame != p->tail[bucket])
+            return false;
+    }
+    return visited == filled;
+}
+
+static bool loadPredictiveSim(CkptBuffer *b, PredictiveSim *sim, int expectedFrames, int distinctPages) {
+    Predictor *p = &sim->predictor;
+    int frameCount;
+    
+    CKPT_GET(b, frameCount);
+    if(!b->ok || frameCount != expectedFrames || !predictiveInit(sim, frameCount, distinctPages))
+        return false;
+    
+    CKPT_GET(b, sim->filled);
+    CKPT_GET(b, sim->accesses);
+    CKPT_GET(b, sim->hits);
+    CKPT_GET(b, sim->faults);
+    CKPT_GET(b, p->now);
+    CKPT_GET(b, p->epoch);
+    ckptGet(b, p->head, sizeof(p->head));
+    ckptGet(b, p->tail, sizeof(p->tail));
+    if(!b->ok || sim->filled < 0 || sim->filled > frameCount) {
+        predictiveFree(sim);
+        return false;
+    }
+    ckptGet(b, p->counters, (size_t)1 << PREDICTOR_BITS);
+    ckptGet(b, p->occupancy, p->window * sizeof(int));
+    ckptGet(b, p->samplerPage, sizeof(uint64_t) << SAMPLER_BITS);
+    ckptGet(b, p->samplerTime, sizeof(long long) << SAMPLER_BITS);
+    ckptGet(b, sim->framePage, sim->filled * sizeof(int));
+    ckptGet(b, p->stamp, sim->filled * sizeof(long long));
+    ckptGet(b, p->prev, sim->filled * sizeof(int));
+    ckptGet(b, p->next, sim->filled * sizeof(int));
+    if(!b->ok || !predictiveSimValid(sim)) {
+        predictiveFree(sim);
+        return false;
+    }
+    return true;
+}
+
+/* Serializes the full run state; the caller owns b */
+void saveCheckpoint(CkptBuffer *b, const LongRun *run) {
+    uint32_t version = CKPT_VERSION;
+    int p;
+    
+    b->length = 0;
+    b->ok = true;
+    ckptPut(b, CKPT_MAGIC, 8);
+    CKPT_PUT(b, version);
+    CKPT_PUT(b, run->fingerprint);
+    CKPT_PUT(b, run->frameCount);
+    CKPT_PUT(b, run->offset);
+    for(p = 0; p < ONLINE_POLICIES; p++) {
+        saveOnlineSim(b, &run->online[p]);
+    }
+    saveOptimalSim(b, &run->optimal);
+    savePredictiveSim(b, &run->predictive);
+}
+
+/* Restores run state from a checkpoint file; false if missing, damaged or for another trace/frame count */
+bool loadCheckpoint(const char *path, LongRun *run, const Trace *t) {
+    FILE *fp = fopen(path, "rb");
+    CkptBuffer b = { NULL, 0, 0, true };
+    char magic[8];
+    uint32_t version;
+    uint64_t fingerprint;
+    int frameCount, p, loaded = 0;
+    long size;
+    bool ok = false, optimalLoaded = false, predictiveLoaded = false;
+    
+    if(fp == NULL)
+        return false;
+    if(fseek(fp, 0, SEEK_END) == 0 && (size = ftell(fp)) > 0 && fseek(fp, 0, SEEK_SET) == 0) {
+        b.data = malloc(size);
+        b.capacity = (size_t)size;
+        if(b.data != NULL && fread(b.data, 1, size, fp) == (size_t)size)
+            ok = true;
+    }
+    fclose(fp);
+    if(!ok) {
+        free(b.data);
+        return false;
+    }
+    
+    ckptGet(&b, magic, 8);
+    CKPT_GET(&b, version);
+    CKPT_GET(&b, fingerprint);
+    CKPT_GET(&b, frameCount);
+    CKPT_GET(&b, run->offset);
+    ok = b.ok && memcmp(magic, CKPT_MAGIC, 8) == 0 && version == CKPT_VERSION &&
+         fingerprint == run->fingerprint && frameCount == run->frameCount &&
+         run->offset >= 0 && run->offset <= t->length;
+    
+    for(p = 0; ok && p < ONLINE_POLICIES; p++) {
+        ok = loadOnlineSim(&b, &run->online[p], p, frameCount);
+        if(ok) loaded++;
+    }
+    if(ok)
+        ok = optimalLoaded = loadOptimalSim(&b, &run->optimal, frameCount, t->distinctPages);
+    if(ok)
+        ok = predictiveLoaded = loadPredictiveSim(&b, &run->predictive, frameCount, t->distinctPages);
+    if(ok)
+        ok = b.length == b.capacity;
+    
+    if(!ok) {
+        for(p = 0; p < loaded; p++) onlineFree(&run->online[p]);
+        if(optimalLoaded) optimalFree(&run->optimal);
+        if(predictiveLoaded) predictiveFree(&run->predictive);
+    }
+    free(b.data);
+    return ok;
+}
+
+/* Writes tmp file then renames, so a crash mid-write keeps the previous checkpoint */
+static bool writeCheckpointFile(const char *path, const CkptBuffer *b) {
+    char tmpPath[300];
+    FILE *fp;
+    bool ok;
+    
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+    fp = fopen(tmpPath, "wb");
+    if(fp == NULL)
+        return false;
+    ok = fwrite(b->data, 1, b->length, fp) == b->length;
+    ok = fflush(fp) == 0 && ok;
+    ok = fclose(fp) == 0 && ok;
+    if(!ok) {
+        remove(tmpPath);
+        return false;
+    }
+    #ifdef _WIN32
+        remove(path);
+    #endif
+    return rename(tmpPath, path) == 0;
+}
+
+/*
+ * Background writer: the simulation thread only serializes into a buffer
+ * and swaps it in; if a newer snapshot arrives before the writer picks up
+ * the previous one, the older one is dropped.
+ */
+static void *checkpointWriterThread(void *arg) {
+    CheckpointWriter *w = arg;
+    CkptBuffer writing = { NULL, 0, 0, true };
+    
+    while(1) {
+        CkptBuffer swap;
+        
+        pthread_mutex_lock(&w->lock);
+        while(!w->hasPending && !w->stop) {
+            pthread_cond_wait(&w->wake, &w->lock);
+        }
+        if(!w->hasPending) {
+            pthread_mutex_unlock(&w->lock);
+            break;
+        }
+        swap = w->pending;
+        w->pending = writing;
+        writing = swap;
+        w->hasPending = false;
+        pthread_mutex_unlock(&w->lock);
+        
+        if(writeCheckpointFile(w->path, &writing)) {
+            pthread_mutex_lock(&w->lock);
+            w->written++;
+            pthread_mutex_unlock(&w->lock);
+        }
+        else {
+            pthread_mutex_lock(&w->lock);
+            w->failed++;
+            pthread_mutex_unlock(&w->lock);
+        }
+    }
+    
+    free(writing.data);
+    return NULL;
+}
+
+int startCheckpointWriter(CheckpointWriter *w, const char *path) {
+    memset(w, 0, sizeof(*w));
+    snprintf(w->path, sizeof(w->path), "%s", path);
+    w->pending.ok = true;
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->wake, NULL);
+    if(pthread_create(&w->thread, NULL, checkpointWriterThread, w) != 0) {
+        pthread_mutex_destroy(&w->lock);
+        pthread_cond_destroy(&w->wake);
+        return 0;
+    }
+    return 1;
+}
+
+/* Hands a serialized snapshot to the writer; *b receives a buffer to reuse */
+void submitCheckpoint(CheckpointWriter *w, CkptBuffer *b) {
+    CkptBuffer swap;
+    
+    pthread_mutex_lock(&w->lock);
+    if(w->hasPending)
+        w->dropped++;
+    swap = w->pending;
+    w->pending = *b;
+    *b = swap;
+    w->hasPending = true;
+    pthread_cond_signal(&w->wake);
+    pthread_mutex_unlock(&w->lock);
+}
+
+/* Writes whatever is still pending, then stops the writer */
+void stopCheckpointWriter(CheckpointWriter *w) {
+    pthread_mutex_lock(&w->lock);
+    w->stop = true;
+    pthread_cond_signal(&w->wake);
+    pthread_mutex_unlock(&w->lock);
+    pthread_join(w->thread, NULL);
+    free(w->pending.data);
+    pthread_mutex_destroy(&w->lock);
+    pthread_cond_destroy(&w->wake);
+}
+
+/*
+ * FIFO, LRU, Optimal, Second Chance and Predictive over the long trace,
+ * with all state in a LongRun so it can be checkpointed every `interval`
+ * references and resumed after a crash with identical results.
+ */
+void checkpointedComparison() {
+    Trace t;
+    LongRun run;
+    CheckpointWriter writer;
+    CkptBuffer buffer = { NULL, 0, 0, true };
+    char path[256];
+    int *nextUse;
+    int interval, resume = 0, startOffset, p, i;
+    bool resumed = false;
+    double start;
+    AlgorithmStats stats[NUM_ALGORITHMS];
+    
+    if(!getAnalysisTrace(&t)) {
+        printf("\nError: No input data! Please enter data or load a trace first.\n");
+        return;
+    }
+    
+    printf("\n--- Long Comparison with Checkpoints ---\n");
+    printf("Trace: %d references, %d distinct pages\n", t.length, t.distinctPages);
+    printf("Enter number of frames: ");
+    scanf("%d", &run.frameCount);
+    printf("Enter checkpoint filename: ");
+    scanf("%255s", path);
+    printf("Enter checkpoint interval (references): ");
+    scanf("%d", &interval);
+    
+    if(run.frameCount < 1) {
+        printf("Invalid! Using default 3 frames.\n");
+        run.frameCount = 3;
+    }
+    if(interval < 1) {
+        printf("Invalid! Using default interval %d.\n", DEFAULT_CHECKPOINT_INTERVAL);
+        interval = DEFAULT_CHECKPOINT_INTERVAL;
+    }
+    
+    run.fingerprint = traceFingerprint(&t);
+    nextUse = buildNextUse(&t);
+    if(nextUse == NULL) {
+        printf("Error: Out of memory.\n");
+        releaseTrace(&t);
+        return;
+    }
+    
+    if(loadCheckpoint(path, &run, &t)) {
+        printf("Checkpoint found at reference %d of %d. Resume? (1 = yes, 0 = start over): ", run.offset, t.length);
+        scanf("%d", &resume);
+        if(resume == 1) {
+            resumed = true;
+        }
+        else {
+            for(p = 0; p < ONLINE_POLICIES; p++) onlineFree(&run.online[p]);
+            optimalFree(&run.optimal);
+            predictiveFree(&run.predictive);
+        }
+    }
+    
+    if(!resumed) {
+        bool ok = true;
+        run.offset = 0;
+        for(p = 0; p < ONLINE_POLICIES; p++) {
+            if(!onlineInit(&run.online[p], p, run.frameCount)) {
+                while(--p >= 0) onlineFree(&run.online[p]);
+                ok = false;
+                break;
+            }
+        }
+        if(ok && !optimalInit(&run.optimal, run.frameCount, t.distinctPages)) {
+            for(p = 0; p < ONLINE_POLICIES; p++) onlineFree(&run.online[p]);
+            ok = false;
+        }
+        if(ok && !predictiveInit(&run.predictive, run.frameCount, t.distinctPages)) {
+            for(p = 0; p < ONLINE_POLICIES; p++) onlineFree(&run.online[p]);
+            optimalFree(&run.optimal);
+            ok = false;
+        }
+        if(!ok) {
+            printf("Error: Out of memory.\n");
+            free(nextUse);
+            releaseTrace(&t);
+            return;
+        }
+    }
+    
+    if(!startCheckpointWriter(&writer, path)) {
+        printf("Error: Cannot start checkpoint writer thread.\n");
+        for(p = 0; p < ONLINE_POLICIES; p++) onlineFree(&run.online[p]);
+        optimalFree(&run.optimal);
+        predictiveFree(&run.predictive);
+        free(nextUse);
+        releaseTrace(&t);
+        return;
+    }
+    
+    printf("\n%s at reference %d...\n", resumed ? "Resuming" : "Starting", run.offset);
+    startOffset = run.offset;
+    start = wallSeconds();
+    for(i = run.offset; i < t.length; i++) {
+        int page = t.refs[i];
+        
+        for(p = 0; p < ONLINE_POLICIES; p++) {
+            onlineAccess(&run.online[p], (uint64_t)page);
+        }
+        optimalAccess(&run.optimal, nextUse, i, page);
+        predictiveAccess(&run.predictive, t.pageIds, page);
+        
+        if((i + 1) % interval == 0 || i + 1 == t.length) {
+            run.offset = i + 1;
+            saveCheckpoint(&buffer, &run);
+            if(buffer.ok) {
+                submitCheckpoint(&writer, &buffer);
+            }
+            else {
+                printf("Warning: Out of memory while saving checkpoint.\n");
+                buffer.ok = true;
+            }
+            printf("Progress: %d / %d references (%.1f%%)\n", run.offset, t.length, (float)run.offset / t.length * 100);
+            fflush(stdout);
+        }
+    }
+    stopCheckpointWriter(&writer);
+    free(buffer.data);
+    
+    printf("\nSimulated %d references in %.2f s\n", t.length - startOffset, wallSeconds() - start);
+    printf("Checkpoints written: %d, superseded before writing: %d, failed: %d\n",
+           writer.written, writer.dropped, writer.failed);
+    
+    /* Online policies keep their POLICY_* index, then Optimal and Predictive */
+    for(p = 0; p < NUM_ALGORITHMS; p++) {
+        long long faults, hits;
+        if(p < ONLINE_POLICIES) {
+            faults = run.online[p].faults;
+            hits = run.online[p].hits;
+            strcpy(stats[p].algorithmName, policyName(p));
+        }
+        else if(p == ONLINE_POLICIES) {
+            faults = run.optimal.faults;
+            hits = run.optimal.hits;
+            strcpy(stats[p].algorithmName, "Optimal");
+        }
+        else {
+            faults = run.predictive.faults;
+            hits = run.predictive.hits;
+            strcpy(stats[p].algorithmName, "Predictive (Hawkeye)");
+        }
+        stats[p].pageFaults = (int)faults;
+        stats[p].pageHits = (int)hits;
+        stats[p].faultRatio = (float)faults / t.length * 100;
+        stats[p].hitRatio = (float)hits / t.length * 100;
+    }
+    
+    printf("\n========================================\n");
+    printf("     COMPARISON SUMMARY (%d frames)\n", run.frameCount);
+    printf("========================================\n");
+    printf("\nAlgorithm\t\tFaults\tHits\tFault%%\n");
+    printf("------------------------------------------------\n");
+    for(p = 0; p < NUM_ALGORITHMS; p++) {
+        printf("%-20s\t%d\t%d\t%.2f%%\n", stats[p].algorithmName, stats[p].pageFaults,
+               stats[p].pageHits, stats[p].faultRatio);
+    }
+    printf("========================================\n");
+    
+    for(p = 0; p < ONLINE_POLICIES; p++) onlineFree(&run.online[p]);
+    optimalFree(&run.optimal);
+    predictiveFree(&run.predictive);
+    free(nextUse);
+    releaseTrace(&t);
+}
+
+/*
+ * Set-partitioned memory: pages are hashed into P partitions of
+ * numFrames/P frames each, so every partition's sub-trace can be
+ * simulated on its own core. This is exact for hardware that really
+ * partitions memory and an approximation of one global pool otherwise.
+ * Each sub-trace gets its own dense page ids, so its per-page tables are
+ * sized by the partition's pages rather than the whole trace's.
+ */
+int partitionTrace(const Trace *t, int partitions, Trace *parts, int **storage) {
+    int *offset = calloc(partitions + 1, sizeof(int));
+    int *pageCount = calloc(partitions, sizeof(int));
+    int *block = malloc(t->length * sizeof(int));
+    int *localId = malloc((t->distinctPages > 0 ? t->distinctPages : 1) * sizeof(int));
+    unsigned char *partOf = malloc(t->distinctPages > 0 ? t->distinctPages : 1);
+    int i, p;
+    
+    if(offset == NULL || pageCount == NULL || block == NULL || localId == NULL || partOf == NULL) {
+        free(offset);
+        free(pageCount);
+        free(block);
+        free(localId);
+        free(partOf);
+        return 0;
+    }
+    
+    /* Hash the original page number once per page, not once per reference */
+    for(i = 0; i < t->distinctPages; i++) {
+        uint64_t page = t->pageIds != NULL ? t->pageIds[i] : (uint64_t)i;
+        partOf[i] = (unsigned char)(hashPage(page, 32) % partitions);
+        localId[i] = pageCount[partOf[i]]++;
+    }
+    for(i = 0; i < t->length; i++) {
+        offset[partOf[t->refs[i]] + 1]++;
+    }
+    for(p = 0; p < partitions; p++) {
+        offset[p + 1] += offset[p];
+        parts[p].refs = block + offset[p];
+        parts[p].pageIds = NULL;
+        parts[p].sizes = NULL;
+        parts[p].costs = NULL;
+        parts[p].length = 0;
+        parts[p].distinctPages = pageCount[p];
+        parts[p].owned = false;
+    }
+    for(i = 0; i < t->length; i++) {
+        Trace *part = &parts[partOf[t->refs[i]]];
+        part->refs[part->length++] = localId[t->refs[i]];
+    }
+    
+    free(offset);
+    free(pageCount);
+    free(localId);
+    free(partOf);
+    *storage = block;
+    return 1;
+}
+
+typedef struct {
+    const Trace *trace;
+    Trace *parts;
+    int frameCount;
+    int partitions;
+    int *lruFaults;
+    int *clockFaults;
+} PartitionJob;
+
+/*
+ * LRU on the O(1) OnlineSim list. lruRun() scans the frame table
+ * for every victim, so shorter per-partition scans would show up as
+ * speedup that has nothing to do with running partitions in parallel.
+ */
+static int partitionLruFaultCount(const Trace *t, int frameCount) {
+    OnlineSim sim;
+    int i, faults;
+    
+    if(!onlineInit(&sim, POLICY_LRU, frameCount))
+        return -1;
+    for(i = 0; i < t->length; i++) {
+        onlineAccess(&sim, (uint64_t)t->refs[i]);
+    }
+    faults = (int)sim.faults;
+    onlineFree(&sim);
+    return faults;
+}
+
+static void partitionTask(void *ctx, int index) {
+    PartitionJob *job = ctx;
+    int p = index / 2;
+    int frames = job->frameCount / job->partitions + (p < job->frameCount % job->partitions ? 1 : 0);
+    
+    if(index % 2 == 0)
+        job->lruFaults[p] = partitionLruFaultCount(&job->parts[p], frames);
+    else
+        job->clockFaults[p] = secondChanceFaultCount(&job->parts[p], frames);
+}
+
+static void fullTraceTask(void *ctx, int index) {
+    PartitionJob *job = ctx;
+    
+    if(index == 0)
+        job->lruFaults[0] = partitionLruFaultCount(job->trace, job->frameCount);
+    else
+        job->clockFaults[0] = secondChanceFaultCount(job->trace, job->frameCount);
+}
+
+/*
+ * Runs LRU and Second Chance with 1, 2, 4, ... P partitions and compares
+ * each against the unpartitioned lruAlgorithm/secondChanceAlgorithm
+ * result, marking partition counts whose error stays within SAFE_PARTITION_ERROR.
+ */
+void partitionedSimulation() {
+    Trace t;
+    PartitionJob job;
+    Trace parts[MAX_PARTITIONS];
+    int lruFaults[MAX_PARTITIONS], clockFaults[MAX_PARTITIONS];
+    int frameCount, maxPartitions, partitions, p;
+    int exactLru, exactClock;
+    double start, exactTime;
+    
+    if(!getAnalysisTrace(&t)) {
+        printf("\nError: No input data! Please enter data or load a trace first.\n");
+        return;
+    }
+    
+    printf("\n--- Hash-Partitioned Parallel Simulation ---\n");
+    printf("Trace: %d references, %d distinct pages\n", t.length, t.distinctPages);
+    printf("Enter number of frames: ");
+    scanf("%d", &frameCount);
+    printf("Enter maximum number of partitions (1-%d, 0 = one per core): ", MAX_PARTITIONS);
+    scanf("%d", &maxPartitions);
+    
+    if(frameCount < 1) {
+        printf("Invalid! Using default 3 frames.\n");
+        frameCount = 3;
+    }
+    if(maxPartitions < 1 || maxPartitions > MAX_PARTITIONS) {
+        maxPartitions = getCoreCount();
+        printf("Using %d partitions (one per core).\n", maxPartitions);
+    }
+    if(maxPartitions > frameCount) {
+        printf("Each partition needs a frame. Limiting to %d partitions.\n", frameCount);
+        maxPartitions = frameCount;
+    }
+    
+    job.trace = &t;
+    job.frameCount = frameCount;
+    job.lruFaults = lruFaults;
+    job.clockFaults = clockFaults;
+    
+    start = wallSeconds();
+    runParallel(2, fullTraceTask, &job);
+    exactTime = wallSeconds() - start;
+    exactLru = lruFaults[0];
+    exactClock = clockFaults[0];
+    if(exactLru < 0 || exactClock < 0) {
+        printf("Error: Out of memory.\n");
+        releaseTrace(&t);
+        return;
+    }
+    
+    printf("\nUnpartitioned (%d frames): LRU %d faults, Second Chance %d faults, %.3f s\n",
+           frameCount, exactLru, exactClock, exactTime);
+    printf("\n%5s %11s %11s %8s %11s %8s %9s %8s\n",
+           "Parts", "Frames/part", "LRU", "Error", "SC", "Error", "Time(s)", "Speedup");
+    printf("----- ----------- ----------- -------- ----------- -------- --------- --------\n");
+    
+    for(partitions = 1; ; partitions *= 2) {
+        int *storage;
+        char framesPerPart[24];
+        long long lruTotal = 0, clockTotal = 0;
+        double lruError, clockError, elapsed;
+        bool failed = false;
+        
+        if(partitions > maxPartitions)
+            partitions = maxPartitions;
+        start = wallSeconds();
+        if(!partitionTrace(&t, partitions, parts, &storage)) {
+            printf("Error: Out of memory.\n");
+            break;
+        }
+        job.parts = parts;
+        job.partitions = partitions;
+        runParallel(2 * partitions, partitionTask, &job);
+        elapsed = wallSeconds() - start;
+        free(storage);
+        
+        for(p = 0; p < partitions; p++) {
+            if(lruFaults[p] < 0 || clockFaults[p] < 0) failed = true;
+            lruTotal += lruFaults[p];
+            clockTotal += clockFaults[p];
+        }
+        if(failed) {
+            printf("%5d Out of memory\n", partitions);
+            break;
+        }
+        
+        lruError = (double)(lruTotal - exactLru) / exactLru * 100;
+        clockError = (double)(clockTotal - exactClock) / exactClock * 100;
+        /* The first frameCount % partitions partitions get one extra frame */
+        if(frameCount % partitions == 0)
+            snprintf(framesPerPart, sizeof(framesPerPart), "%d", frameCount / partitions);
+        else
+            snprintf(framesPerPart, sizeof(framesPerPart), "%d-%d", frameCount / partitions, frameCount / partitions + 1);
+        printf("%5d %11s %11lld %+7.2f%% %11lld %+7.2f%% %9.3f %7.2fx%s\n",
+               partitions, framesPerPart, lruTotal, lruError, clockTotal, clockError,
+               elapsed, elapsed > 0 ? exactTime / elapsed : 0.0,
+               fabs(lruError) <= SAFE_PARTITION_ERROR && fabs(clockError) <= SAFE_PARTITION_ERROR ? "  safe" : "");
+        
+        if(partitions == maxPartitions)
+            break;
+    }
+    
+    printf("\n'safe' = both policies within %.1f%% of the unpartitioned fault count.\n", SAFE_PARTITION_ERROR);
+    releaseTrace(&t);
+}
+
+/*
+ * Object cache with capacity in bytes. All three policies keep the cached
+ * objects in a min-heap on a priority H and evict the minimum:
+ *   LRU   H = time of last access
+ *   GDS   H = L + cost / size
+ *   GDSF  H = L + frequency * cost / size
+ * where L is raised to the H of each evicted object, so objects that are
+ * not re-referenced age relative to newly inserted ones.
+ */
+static void objectRemove(ObjectCache *c, int id) {
+    c->usedBytes -= c->cachedSize[id];
+    indexedHeapRemove(&c->heap, id);
+}
+
+static double objectPriority(const ObjectCache *c, int id, float cost, long long now) {
+    switch(c->policy) {
+        case OBJECT_LRU:
+            return (double)now;
+        case OBJECT_GDS:
+            return c->inflation + (double)cost / c->cachedSize[id];
+        default:
+            return c->inflation + (double)c->frequency[id] * cost / c->cachedSize[id];
+    }
+}
+
+int objectCacheInit(ObjectCache *c, int policy, long long capacityBytes, int distinctObjects) {
+    memset(c, 0, sizeof(*c));
+    c->policy = policy;
+    c->capacityBytes = capacityBytes;
+    c->cachedSize = malloc(distinctObjects * sizeof(unsigned int));
+    c->frequency = malloc(distinctObjects * sizeof(unsigned int));
+    if(!indexedHeapInit(&c->heap, distinctObjects) || c->cachedSize == NULL || c->frequency == NULL) {
+        objectCacheFree(c);
+        return 0;
+    }
+    return 1;
+}
+
+void objectCacheFree(ObjectCache *c) {
+    indexedHeapFree(&c->heap);
+    free(c->cachedSize);
+    free(c->frequency);
+    c->cachedSize = c->frequency = NULL;
+}
+
+/* One request; an object whose size changed since it was cached is refetched */
+bool objectCacheAccess(ObjectCache *c, int id, unsigned int size, float cost, long long now) {
+    c->requests++;
+    c->requestedBytes += size;
+    
+    if(c->heap.pos[id] != -1) {
+        if(c->cachedSize[id] == size) {
+            c->hits++;
+            c->hitBytes += size;
+            c->frequency[id]++;
+            indexedHeapSet(&c->heap, id, objectPriority(c, id, cost, now));
+            return true;
+        }
+        objectRemove(c, id);
+    }
+    
+    c->missCost += cost;
+    if(size > c->capacityBytes) {
+        c->bypassed++;
+        return false;
+    }
+    
+    while(c->usedBytes + size > c->capacityBytes) {
+        int victim = c->heap.items[0];
+        if(c->policy != OBJECT_LRU)
+            c->inflation = c->heap.key[victim];
+        objectRemove(c, victim);
+        c->evictions++;
+    }
+    
+    c->cachedSize[id] = size;
+    c->frequency[id] = 1;
+    c->usedBytes += size;
+    indexedHeapSet(&c->heap, id, objectPriority(c, id, cost, now));
+    return false;
+}
+
+const char *objectPolicyName(int policy) {
+    switch(policy) {
+        case OBJECT_LRU: return "LRU (bytes)";
+        case OBJECT_GDS: return "GreedyDual-Size";
+        default: return "GDSF";
+    }
+}
+
+typedef struct {
+    const Trace *trace;
+    long long capacityBytes;
+    ObjectCache caches[OBJECT_POLICIES];
+    int ok[OBJECT_POLICIES];
+} ObjectJob;
+
+static void objectCacheTask(void *ctx, int policy) {
+    ObjectJob *job = ctx;
+    const Trace *t = job->trace;
+    ObjectCache *c = &job->caches[policy];
+    int i;
+    
+    job->ok[policy] = objectCacheInit(c, policy, job->capacityBytes, t->distinctPages);
+    if(!job->ok[policy])
+        return;
+    for(i = 0; i < t->length; i++) {
+        unsigned int size = t->sizes != NULL ? t->sizes[i] : 1;
+        float cost = t->costs != NULL ? t->costs[i] : 1.0f;
+        objectCacheAccess(c, t->refs[i], size, cost, i);
+    }
+}
+
+void objectCacheSimulation() {
+    Trace t;
+    ObjectJob job;
+    long long capacity;
+    int p;
+    
+    if(!getAnalysisTrace(&t)) {
+        printf("\nError: No input data! Please enter data or load a trace first.\n");
+        return;
+    }
+    
+    printf("\n--- Object Cache Simulation (GreedyDual-Size) ---\n");
+    printf("Trace: %d requests, %d distinct objects, %s\n", t.length, t.distinctPages,
+           t.sizes != NULL ? "with sizes/costs" : "unit size and cost");
+    printf("Enter cache capacity in bytes: ");
+    scanf("%lld", &capacity);
+    
+    if(capacity < 1) {
+        printf("Invalid! Using default capacity of 3 bytes.\n");
+        capacity = 3;
+    }
+    
+    job.trace = &t;
+    job.capacityBytes = capacity;
+    runParallel(OBJECT_POLICIES, objectCacheTask, &job);
+    
+    printf("\n%-16s %10s %10s %11s %12s %10s %10s\n",
+           "Policy", "Hits", "Obj Hit%", "Byte Hit%", "Miss Cost", "Evictions", "Bypassed");
+    printf("---------------- ---------- ---------- ----------- ------------ ---------- ----------\n");
+    for(p = 0; p < OBJECT_POLICIES; p++) {
+        ObjectCache *c = &job.caches[p];
+        if(!job.ok[p]) {
+            printf("%-16s Out of memory\n", objectPolicyName(p));
+            continue;
+        }
+        printf("%-16s %10lld %9.2f%% %10.2f%% %12.1f %10lld %10lld\n", objectPolicyName(p), c->hits,
+               (float)c->hits / c->requests * 100,
+               c->requestedBytes ? (float)((double)c->hitBytes / c->requestedBytes * 100) : 0.0f,
+               c->missCost, c->evictions, c->bypassed);
+        objectCacheFree(c);
+    }
+    printf("\nObject hit ratio counts requests; byte hit ratio weights them by size.\n");
+    
+    releaseTrace(&t);
+}
+
+/*
+ * CLOCK with a saturating `bits`-wide use counter per frame: a hit adds
+ * one, the hand takes one away and evicts the first frame at zero, so a
+ * frequently used page survives several sweeps. bits = 1 is exactly
+ * secondChanceAlgorithm().
+ */
+int agingClockFaultCount(const Trace *t, int frameCount, int bits) {
+    int *slotOf = malloc(sizeof(int) * (t->distinctPages > 0 ? t->distinctPages : 1));
+    int *framePage = malloc(sizeof(int) * frameCount);
+    unsigned char *counter = malloc(frameCount);
+    unsigned char top = (unsigned char)((1 << bits) - 1);
+    int filled = 0, hand = 0, faults = 0, i;
+    
+    if(slotOf == NULL || framePage == NULL || counter == NULL) {
+        free(slotOf);
+        free(framePage);
+        free(counter);
+        return -1;
+    }
+    for(i = 0; i < t->distinctPages; i++) {
+        slotOf[i] = -1;
+    }
+    
+    for(i = 0; i < t->length; i++) {
+        int page = t->refs[i];
+        int slot = slotOf[page];
+        
+        if(slot != -1) {
+            if(counter[slot] < top)
+                counter[slot]++;
+            continue;
+        }
+        faults++;
+        if(filled < frameCount) {
+            slot = filled++;
+        }
+        else {
+            while(counter[hand] != 0) {
+                counter[hand]--;
+                if(++hand == frameCount)
+                    hand = 0;
+            }
+            slot = hand;
+            slotOf[framePage[slot]] = -1;
+            if(++hand == frameCount)
+                hand = 0;
+        }
+        framePage[slot] = page;
+        slotOf[page] = slot;
+        counter[slot] = 1;
+    }
+    
+    free(slotOf);
+    free(framePage);
+    free(counter);
+    return faults;
+}
+
+/*
+ * LRU-K: evict the page whose K-th most recent reference is oldest. Pages
+ * referenced fewer than K times rank before all others, in LRU order.
+ * The key packs both cases into one number (see lruKKey) so a min-heap
+ * over frames gives the victim; reference history is kept for every page.
+ */
+typedef struct {
+    int k;
+    int length;
+    int *times;                 /* last k reference times per page, ring buffer */
+    int *refCount;
+    IndexedHeap heap;           /* frames on key */
+} LruKSim;
+
+static long long lruKKey(const LruKSim *sim, int page, int now) {
+    if(sim->refCount[page] < sim->k)
+        return now;
+    return (long long)sim->length + sim->times[(long long)page * sim->k + sim->refCount[page] % sim->k];
+}
+
+int lruKFaultCount(const Trace *t, int frameCount, int k) {
+    LruKSim sim;
+    int distinct = t->distinctPages > 0 ? t->distinctPages : 1;
+    int *slotOf = malloc(sizeof(int) * distinct);
+    int *framePage = malloc(sizeof(int) * frameCount);
+    int faults = 0, i;
+    
+    sim.k = k;
+    sim.length = t->length;
+    sim.times = malloc(sizeof(int) * (size_t)distinct * k);
+    sim.refCount = calloc(distinct, sizeof(int));
+    if(!indexedHeapInit(&sim.heap, frameCount) || slotOf == NULL || framePage == NULL ||
+       sim.times == NULL || sim.refCount == NULL) {
+        faults = -1;
+        goto done;
+    }
+    for(i = 0; i < t->distinctPages; i++) {
+        slotOf[i] = -1;
+    }
+    
+    for(i = 0; i < t->length; i++) {
+        int page = t->refs[i];
+        int slot = slotOf[page];
+        
+        sim.times[(long long)page * k + sim.refCount[page] % k] = i;
+        sim.refCount[page]++;
+        
+        if(slot != -1) {
+            indexedHeapSet(&sim.heap, slot, (double)lruKKey(&sim, page, i));
+            continue;
+        }
+        faults++;
+        if(sim.heap.size < frameCount)
+            slot = sim.heap.size;
+        else {
+            slot = sim.heap.items[0];
+            slotOf[framePage[slot]] = -1;
+        }
+        indexedHeapSet(&sim.heap, slot, (double)lruKKey(&sim, page, i));
+        framePage[slot] = page;
+        slotOf[page] = slot;
+    }
+    
+done:
+    free(slotOf);
+    free(framePage);
+    free(sim.times);
+    free(sim.refCount);
+    indexedHeapFree(&sim.heap);
+    return faults;
+}
+
+/*
+ * Segmented LRU: new pages enter a probationary segment and move to the
+ * protected segment on their second reference. The protected segment
+ * holds protectedPercent of the frames; its overflow drops back to the
+ * head of probation, and victims come from the tail of probation.
+ * protectedPercent = 0 is plain LRU.
+ */
+#define SLRU_PROBATION 1
+#define SLRU_PROTECTED 2
+
+int slruFaultCount(const Trace *t, int frameCount, int protectedPercent) {
+    SegList lists;
+    int protectedFrames = (int)((long long)frameCount * protectedPercent / 100);
+    int faults = 0, i;
+    
+    if(!segListInit(&lists, t->distinctPages))
+        return -1;
+    
+    for(i = 0; i < t->length; i++) {
+        int page = t->refs[i];
+        int seg = lists.segmentOf[page];
+        
+        if(seg == SLRU_PROTECTED || (seg == SLRU_PROBATION && protectedFrames == 0)) {
+            segListUnlink(&lists, page);
+            segListPushFront(&lists, seg, page);
+            continue;
+        }
+        if(seg == SLRU_PROBATION) {
+            segListUnlink(&lists, page);
+            if(lists.count[SLRU_PROTECTED] == protectedFrames) {
+                int demoted = lists.tail[SLRU_PROTECTED];
+                segListUnlink(&lists, demoted);
+                segListPushFront(&lists, SLRU_PROBATION, demoted);
+            }
+            segListPushFront(&lists, SLRU_PROTECTED, page);
+            continue;
+        }
+        
+        faults++;
+        if(lists.count[SLRU_PROBATION] + lists.count[SLRU_PROTECTED] == frameCount) {
+            int victim = lists.count[SLRU_PROBATION] > 0 ? lists.tail[SLRU_PROBATION] : lists.tail[SLRU_PROTECTED];
+            segListUnlink(&lists, victim);
+        }
+        segListPushFront(&lists, SLRU_PROBATION, page);
+    }
+    
+    segListFree(&lists);
+    return faults;
+}
+
+const TunableFamily tunableFamilies[] = {
+    { "CLOCK (aging)", "counter bits", { 1, 2, 3, 4 }, 4, 1, agingClockFaultCount },
+    { "LRU-K", "K", { 1, 2, 3, 4 }, 4, 2, lruKFaultCount },
+    { "SLRU", "protected %", { 0, 10, 20, 30, 40, 50, 60, 70, 80, 90 }, 10, 80, slruFaultCount },
+};
+
+#define TUNABLE_FAMILIES ((int)(sizeof(tunableFamilies) / sizeof(tunableFamilies[0])))
+
+typedef struct {
+    int family;
+    int value;
+    int faults;                 /* on the prefix of the latest round */
+} TuningConfig;
+
+typedef struct {
+    Trace prefix;               /* the trace with a shorter length */
+    int frameCount;
+    TuningConfig *configs;
+} TuningJob;
+
+static void tuningTask(void *ctx, int index) {
+    TuningJob *job = ctx;
+    TuningConfig *c = &job->configs[index];
+    
+    c->faults = tunableFamilies[c->family].faults(&job->prefix, job->frameCount, c->value);
+}
+
+static bool isDefaultConfig(const TuningConfig *c) {
+    return c->value == tunableFamilies[c->family].defaultValue;
+}
+
+/* Fewest faults first; a default wins ties so gains are never overstated */
+static int compareTuningConfigs(const void *a, const void *b) {
+    const TuningConfig *x = a, *y = b;
+    
+    if(x->faults != y->faults)
+        return x->faults < y->faults ? -1 : 1;
+    if(isDefaultConfig(x) != isDefaultConfig(y))
+        return isDefaultConfig(x) ? -1 : 1;
+    if(x->family != y->family)
+        return x->family - y->family;
+    return x->value - y->value;
+}
+
+static const char *tuningLabel(const TuningConfig *c, char *label, int size) {
+    snprintf(label, size, "%s, %s = %d", tunableFamilies[c->family].name,
+             tunableFamilies[c->family].parameter, c->value);
+    return label;
+}
+
+/*
+ * Successive halving: every configuration runs on a short prefix of the
+ * trace, the better half survives and the prefix doubles, until the last
+ * round runs the finalists on the whole trace. Each round's
+ * configurations run in parallel. Failed runs (-1) rank last.
+ */
+void parameterTuning() {
+    Trace t;
+    TuningJob job;
+    TuningConfig configs[TUNABLE_FAMILIES * MAX_TUNING_VALUES];
+    TuningConfig defaults[TUNABLE_FAMILIES];
+    char label[64];
+    int count = 0, total, rounds = 0, round, f, v, i;
+    long long simulated = 0;
+    double start;
+    
+    if(!getAnalysisTrace(&t)) {
+        printf("\nError: No input data! Please enter data or load a trace first.\n");
+        return;
+    }
+    
+    printf("\n--- Policy Parameter Tuning ---\n");
+    printf("Trace: %d references, %d distinct pages\n", t.length, t.distinctPages);
+    printf("Enter number of frames: ");
+    scanf("%d", &job.frameCount);
+    
+    if(job.frameCount < 1) {
+        printf("Invalid! Using default 3 frames.\n");
+        job.frameCount = 3;
+    }
+    
+    for(f = 0; f < TUNABLE_FAMILIES; f++) {
+        for(v = 0; v < tunableFamilies[f].valueCount; v++) {
+            configs[count].family = f;
+            configs[count].value = tunableFamilies[f].values[v];
+            count++;
+        }
+        defaults[f].family = f;
+        defaults[f].value = tunableFamilies[f].defaultValue;
+    }
+    total = count;
+    while((1 << rounds) < count) {
+        rounds++;
+    }
+    
+    printf("\n%d configurations, %d rounds, %d threads\n", count, rounds, getCoreCount());
+    printf("\n%-6s %12s %8s   %-32s %8s\n", "Round", "Prefix", "Configs", "Leader", "Miss%");
+    printf("------ ------------ --------   -------------------------------- --------\n");
+    
+    start = wallSeconds();
+    job.configs = configs;
+    for(round = 0; round < rounds; round++) {
+        int length = t.length >> (rounds - 1 - round);
+        
+        if(length < MIN_TUNING_PREFIX)
+            length = t.length < MIN_TUNING_PREFIX ? t.length : MIN_TUNING_PREFIX;
+        job.prefix = t;
+        job.prefix.length = length;
+        runParallel(count, tuningTask, &job);
+        simulated += (long long)count * length;
+        
+        for(i = 0; i < count; i++) {
+            if(configs[i].faults < 0)
+                configs[i].faults = INT_MAX;
+        }
+        qsort(configs, count, sizeof(configs[0]), compareTuningConfigs);
+        
+        printf("%-6d %12d %8d   %-32s %7.2f%%\n", round + 1, length, count,
+               tuningLabel(&configs[0], label, sizeof(label)), (float)configs[0].faults / length * 100);
+        count = (count + 1) / 2;
+    }
+    
+    job.prefix = t;
+    job.configs = defaults;
+    runParallel(TUNABLE_FAMILIES, tuningTask, &job);
+    simulated += (long long)TUNABLE_FAMILIES * t.length;
+    
+    if(configs[0].faults == INT_MAX) {
+        printf("\nError: Out of memory!\n");
+        releaseTrace(&t);
+        return;
+    }
+    
+    printf("\nBest configuration: %s\n", tuningLabel(&configs[0], label, sizeof(label)));
+    printf("Miss ratio: %.2f%% (%d faults)\n", (float)configs[0].faults / t.length * 100, configs[0].faults);
+    
+    printf("\n%-32s %8s %10s %12s\n", "Default", "Miss%", "Gain (pp)", "Faults saved");
+    printf("-------------------------------- -------- ---------- ------------\n");
+    for(f = 0; f < TUNABLE_FAMILIES; f++) {
+        printf("%-32s", tuningLabel(&defaults[f], label, sizeof(label)));
+        if(defaults[f].faults < 0) {
+            printf(" Out of memory\n");
+            continue;
+        }
+        printf(" %7.2f%% %10.2f %12d\n", (float)defaults[f].faults / t.length * 100,
+               (float)(defaults[f].faults - configs[0].faults) / t.length * 100,
+               defaults[f].faults - configs[0].faults);
+    }
+    
+    printf("\nSimulated %lld references in %.2f s (exhaustive search: %lld)\n", simulated,
+           wallSeconds() - start, (long long)total * t.length);
+    
+    releaseTrace(&t);
+}